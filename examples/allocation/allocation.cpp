@@ -0,0 +1,115 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/multi_classifier.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+
+// Counts every heap allocation of the process (Eigen calls malloc directly,
+// so operator new alone would miss most of them).
+namespace {
+  std::atomic<std::size_t> allocations(0);
+}
+
+extern "C" {
+  void* __libc_malloc(std::size_t size);
+  void* __libc_calloc(std::size_t n, std::size_t size);
+  void* __libc_realloc(void* p, std::size_t size);
+
+  void* malloc(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+  }
+
+  void* calloc(std::size_t n, std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+  }
+
+  void* realloc(void* p, std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, size);
+  }
+}
+
+// Runs parse -> update -> predict over the lines twice and returns the
+// number of allocations of the second (steady state) pass.
+template <typename Label, class Learner>
+std::size_t count(Learner learner, const std::vector<std::string>& lines, const std::size_t dim) {
+  Eigen::VectorXd x(dim);
+  std::size_t before = 0;
+  for (auto pass = 0; pass < 2; ++pass) {
+    before = allocations.load();
+    for (const auto& line : lines) {
+      const auto label = utility::read_ones<Label>(line, x);
+      learner.update(x, label);
+      learner.predict(x);
+    }
+  }
+  return allocations.load() - before;
+}
+
+std::vector<std::string> read_lines(const std::string& path) {
+  std::vector<std::string> lines;
+  std::ifstream ifs(path);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (!line.empty()) { lines.push_back(line); }
+  }
+  return lines;
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("class", value<std::size_t>()->default_value(0), "クラス数")
+    ("train", value<std::string>()->default_value(""), "2値分類の学習データのファイルパス")
+    ("multi", value<std::string>()->default_value(""), "多値分類の学習データのファイルパス");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto n_class = vm["class"].as<std::size_t>();
+  const auto binary = read_lines(vm["train"].as<std::string>());
+  const auto multi = read_lines(vm["multi"].as<std::string>());
+
+  std::vector<std::pair<std::string, std::size_t>> results;
+  if (!binary.empty()) {
+    results.emplace_back("AROW", count<int>(AROW(dim, 0.5), binary, dim));
+    results.emplace_back("SCW", count<int>(SCW(dim, 1.0, 1.0), binary, dim));
+    results.emplace_back("NHERD", count<int>(NHERD(dim, 1.0), binary, dim));
+    results.emplace_back("PA", count<int>(PA(dim, 1.0), binary, dim));
+    results.emplace_back("ADAM", count<int>(ADAM(dim), binary, dim));
+    results.emplace_back("ADAGRAD_RDA", count<int>(ADAGRAD_RDA(dim, 0.1, 0.001), binary, dim));
+    results.emplace_back("AVERAGED_PA", count<int>(AVERAGED_PA(dim, 1.0), binary, dim));
+    results.emplace_back("AVERAGED_AROW", count<int>(AVERAGED_AROW(dim, 0.5), binary, dim));
+  }
+  if (!multi.empty()) {
+    results.emplace_back("MAROW", count<std::size_t>(MAROW(dim, n_class, 0.5), multi, dim));
+    results.emplace_back("MSCW", count<std::size_t>(MSCW(dim, n_class, 1.0, 1.0), multi, dim));
+    results.emplace_back("MNHERD", count<std::size_t>(MNHERD(dim, n_class, 1.0), multi, dim));
+    results.emplace_back("MPA", count<std::size_t>(MPA(dim, n_class, 1.0), multi, dim));
+    results.emplace_back("MCPA", count<std::size_t>(MCPA(dim, n_class, 1.0), multi, dim));
+    results.emplace_back("MCAROW", count<std::size_t>(MCAROW(dim, n_class, 0.5), multi, dim));
+    results.emplace_back("MCSCW", count<std::size_t>(MCSCW(dim, n_class, 1.0, 0.9), multi, dim));
+  }
+
+  auto failed = false;
+  for (const auto& result : results) {
+    std::cout << result.first << " allocations = " << result.second << std::endl;
+    failed = failed || result.second > 0;
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,262 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/multi_classifier.hpp>
+#include <mochimochi/utility.hpp>
+#include <mochimochi/kernel/dispatch.hpp>
+#include <boost/program_options.hpp>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Synthetic data set : labels are given by a hidden linear model
+// (sign of the margin for binary, argmax of the class scores for multi-class).
+struct Dataset {
+  std::string name;
+  std::vector<Eigen::VectorXd> features;
+  std::vector<int> binary_labels;
+  std::vector<std::size_t> multi_labels;
+};
+
+struct Config {
+  std::size_t dim;
+  std::size_t nnz;
+  std::size_t n_class;
+  std::size_t examples;
+  std::size_t repeat;
+  double zipf;
+  unsigned int seed;
+};
+
+// Weighted sampling without replacement : the weights are the leaves of a sum tree,
+// and a drawn index has its leaf set to zero until the example is complete, so that
+// every draw costs O(log dim) however many indices are already used (even nnz = dim).
+class Sampler {
+private :
+  std::vector<double> _weights;
+  std::vector<double> _tree;
+  std::size_t _leaves;
+
+  // the parents are recomputed rather than updated, so that a used index weighs exactly zero
+  void set(std::size_t i, const double weight) {
+    i += _leaves;
+    _tree[i] = weight;
+    for (i /= 2; i > 0; i /= 2) { _tree[i] = _tree[2 * i] + _tree[2 * i + 1]; }
+  }
+
+  // walks down to a leaf of nonzero weight, u in [0, total)
+  std::size_t find(double u) const {
+    std::size_t i = 1;
+    while (i < _leaves) {
+      const auto left = _tree[2 * i];
+      if (_tree[2 * i + 1] == 0.0 || (left > 0.0 && u < left)) {
+        i = 2 * i;
+      } else {
+        u -= left;
+        i = 2 * i + 1;
+      }
+    }
+    return i - _leaves;
+  }
+
+public :
+  explicit Sampler(const std::vector<double>& weights)
+    : _weights(weights),
+      _leaves(1) {
+    while (_leaves < weights.size()) { _leaves *= 2; }
+    _tree.assign(2 * _leaves, 0.0);
+    for (std::size_t i = 0; i < weights.size(); ++i) { _tree[_leaves + i] = weights[i]; }
+    for (auto i = _leaves - 1; i > 0; --i) { _tree[i] = _tree[2 * i] + _tree[2 * i + 1]; }
+  }
+
+  template <class Engine>
+  void draw(const std::size_t n, Engine& engine, std::vector<std::size_t>& indices) {
+    assert(n <= _weights.size());
+    indices.clear();
+    while (indices.size() < n) {
+      const auto index = find(std::uniform_real_distribution<double>(0.0, _tree[1])(engine));
+      set(index, 0.0);
+      indices.push_back(index);
+    }
+    for (const auto index : indices) { set(index, _weights[index]); }
+  }
+};
+
+// Feature indices are drawn with P(rank i) ~ 1 / i^s (s = 0 : uniform),
+// without replacement inside an example.
+Dataset generate(const Config& config, const bool dense) {
+  std::mt19937 engine(config.seed);
+  std::normal_distribution<double> normal(0.0, 1.0);
+
+  std::vector<double> frequencies(config.dim);
+  for (std::size_t i = 0; i < config.dim; ++i) { frequencies[i] = 1.0 / std::pow(i + 1.0, config.zipf); }
+  Sampler zipf(frequencies);
+
+  Eigen::MatrixXd truth(config.dim, std::max<std::size_t>(config.n_class, 1));
+  for (auto i = 0; i < truth.size(); ++i) { truth(i) = normal(engine); }
+
+  Dataset dataset;
+  dataset.name = dense ? "dense" : "sparse";
+  const auto nnz = std::min(config.nnz, config.dim);
+  std::vector<std::size_t> indices;
+  for (std::size_t n = 0; n < config.examples; ++n) {
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(config.dim);
+    if (dense) {
+      for (std::size_t i = 0; i < config.dim; ++i) { x[i] = normal(engine); }
+    } else {
+      zipf.draw(nnz, engine, indices);
+      for (const auto index : indices) { x[index] = normal(engine); }
+    }
+
+    Eigen::VectorXd::Index best;
+    (truth.transpose() * x).maxCoeff(&best);
+    dataset.binary_labels.push_back(truth.col(0).dot(x) > 0.0 ? 1 : -1);
+    dataset.multi_labels.push_back(best + 1);
+    dataset.features.push_back(x);
+  }
+  return dataset;
+}
+
+// One JSON object per line so that the results can be collected across releases.
+void emit(const std::string& benchmark, const std::string& learner, const Dataset& dataset,
+          const Config& config, const std::size_t n_class, const std::size_t count, const double seconds) {
+  std::cout << "{\"benchmark\":\"" << benchmark << "\""
+            << ",\"learner\":\"" << learner << "\""
+            << ",\"dataset\":\"" << dataset.name << "\""
+            << ",\"isa\":\"" << kernel::isa_name(kernel::active_isa()) << "\""
+            << ",\"dim\":" << config.dim
+            << ",\"nnz\":" << (dataset.name == "dense" ? config.dim : std::min(config.nnz, config.dim))
+            << ",\"zipf\":" << config.zipf
+            << ",\"class\":" << n_class
+            << ",\"examples\":" << count
+            << ",\"seconds\":" << seconds
+            << ",\"examples_per_sec\":" << (seconds > 0.0 ? count / seconds : 0.0)
+            << "}" << std::endl;
+}
+
+template <typename Function>
+double measure(Function function) {
+  const auto start = std::chrono::steady_clock::now();
+  function();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+template <class Learner, typename Label>
+void run(const std::string& name, Learner learner, const Dataset& dataset,
+         const std::vector<Label>& labels, const Config& config, const std::size_t n_class) {
+  const auto count = config.repeat * dataset.features.size();
+  const auto update_seconds = measure([&]() {
+      for (std::size_t r = 0; r < config.repeat; ++r) {
+        for (std::size_t i = 0; i < dataset.features.size(); ++i) { learner.update(dataset.features[i], labels[i]); }
+      }
+    });
+  emit("update", name, dataset, config, n_class, count, update_seconds);
+
+  volatile std::size_t sink = 0;
+  const auto predict_seconds = measure([&]() {
+      for (std::size_t r = 0; r < config.repeat; ++r) {
+        for (const auto& x : dataset.features) { sink = sink + learner.predict(x); }
+      }
+    });
+  emit("predict", name, dataset, config, n_class, count, predict_seconds);
+}
+
+void run_parse(const Dataset& dataset, const Config& config) {
+  std::vector<std::string> lines;
+  for (std::size_t i = 0; i < dataset.features.size(); ++i) {
+    std::ostringstream line;
+    line << dataset.binary_labels[i];
+    const auto& x = dataset.features[i];
+    for (auto j = 0; j < x.size(); ++j) {
+      if (x[j] != 0.0) { line << " " << (j + 1) << ":" << x[j]; }
+    }
+    lines.push_back(line.str());
+  }
+
+  volatile double sink = 0.0;
+  const auto seconds = measure([&]() {
+      for (std::size_t r = 0; r < config.repeat; ++r) {
+        for (const auto& line : lines) { sink = sink + utility::read_ones<int>(line, config.dim).second[0]; }
+      }
+    });
+  emit("parse", "read_ones", dataset, config, 0, config.repeat * lines.size(), seconds);
+}
+
+bool selected(const std::string& filter, const std::string& name) {
+  return filter.empty() || ("," + filter + ",").find("," + name + ",") != std::string::npos;
+}
+
+void run_all(const Dataset& dataset, const Config& config, const std::string& filter) {
+  const auto dim = config.dim;
+  const auto& y = dataset.binary_labels;
+  if (selected(filter, "read_ones")) { run_parse(dataset, config); }
+  if (selected(filter, "AROW")) { run("AROW", AROW(dim, 0.5), dataset, y, config, 2); }
+  if (selected(filter, "SCW")) { run("SCW", SCW(dim, 1.0, 0.95), dataset, y, config, 2); }
+  if (selected(filter, "NHERD")) { run("NHERD", NHERD(dim, 0.1, 0), dataset, y, config, 2); }
+  if (selected(filter, "PA")) { run("PA", PA(dim, 1.0, 2), dataset, y, config, 2); }
+  if (selected(filter, "ADAM")) { run("ADAM", ADAM(dim), dataset, y, config, 2); }
+  if (selected(filter, "ADAGRAD_RDA")) { run("ADAGRAD_RDA", ADAGRAD_RDA(dim, 0.1, 0.000001), dataset, y, config, 2); }
+  if (selected(filter, "AVERAGED_PA")) { run("AVERAGED_PA", AVERAGED_PA(dim, 1.0, 2), dataset, y, config, 2); }
+  if (selected(filter, "AVERAGED_AROW")) { run("AVERAGED_AROW", AVERAGED_AROW(dim, 0.5), dataset, y, config, 2); }
+
+  const auto K = config.n_class;
+  if (K < 2) { return; }
+  const auto& c = dataset.multi_labels;
+  if (selected(filter, "MAROW")) { run("MAROW", MAROW(dim, K, 0.5), dataset, c, config, K); }
+  if (selected(filter, "MSCW")) { run("MSCW", MSCW(dim, K, 1.0, 0.95), dataset, c, config, K); }
+  if (selected(filter, "MNHERD")) { run("MNHERD", MNHERD(dim, K, 0.1, 0), dataset, c, config, K); }
+  if (selected(filter, "MPA")) { run("MPA", MPA(dim, K, 1.0, 2), dataset, c, config, K); }
+  if (selected(filter, "MCPA")) { run("MCPA", MCPA(dim, K, 1.0, 2), dataset, c, config, K); }
+  if (selected(filter, "MCAROW")) { run("MCAROW", MCAROW(dim, K, 0.5), dataset, c, config, K); }
+  if (selected(filter, "MCSCW")) { run("MCSCW", MCSCW(dim, K, 1.0, 0.95), dataset, c, config, K); }
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("dim", value<std::size_t>()->default_value(1000), "データの次元数")
+    ("nnz", value<std::size_t>()->default_value(20), "疎なデータの1事例あたりの非ゼロ要素数")
+    ("zipf", value<double>()->default_value(1.0), "疎なデータの特徴の出現頻度のZipf指数 (0 : 一様)")
+    ("class", value<std::size_t>()->default_value(10), "多クラス分類のクラス数 (0 : 二値分類のみ)")
+    ("examples", value<std::size_t>()->default_value(10000), "事例数")
+    ("repeat", value<std::size_t>()->default_value(1), "各計測の繰り返し回数")
+    ("dataset", value<std::string>()->default_value("dense,sparse"), "計測するデータ (dense, sparse)")
+    ("learner", value<std::string>()->default_value(""), "計測する学習器 (カンマ区切り, 空 : すべて)")
+    ("seed", value<unsigned int>()->default_value(1), "乱数のシード")
+    ("isa", value<std::string>()->default_value(""), "使用する命令セット (scalar, sse2, avx2, avx512, 空 : 自動検出)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  Config config;
+  config.dim = vm["dim"].as<std::size_t>();
+  config.nnz = vm["nnz"].as<std::size_t>();
+  config.zipf = vm["zipf"].as<double>();
+  config.n_class = vm["class"].as<std::size_t>();
+  config.examples = vm["examples"].as<std::size_t>();
+  config.repeat = vm["repeat"].as<std::size_t>();
+  config.seed = vm["seed"].as<unsigned int>();
+  const auto datasets = vm["dataset"].as<std::string>();
+  const auto filter = vm["learner"].as<std::string>();
+  if (!vm["isa"].as<std::string>().empty()) { kernel::set_isa(kernel::parse_isa(vm["isa"].as<std::string>())); }
+
+  for (const auto dense : { true, false }) {
+    if (!selected(datasets, dense ? "dense" : "sparse")) { continue; }
+    run_all(generate(config, dense), config, filter);
+  }
+
+  return 0;
+}
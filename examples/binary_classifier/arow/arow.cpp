@@ -1,5 +1,6 @@
 #include <mochimochi/binary_classifier.hpp>
 #include <mochimochi/utility.hpp>
+#include <mochimochi/stats.hpp>
 #include <boost/program_options.hpp>
 #include <iostream>
 
@@ -28,10 +29,12 @@ int main(const int ac, const char* const * const av) {
   std::string line;
   std::ifstream train_data(train_path);
 
-  AROW arow(dim, r);
+  stats::Instrumented<AROW> arow(dim, r);
   std::cout << "training..." << std::endl;
   while(std::getline(train_data, line)) {
+    const stats::Timer timer;
     auto data = utility::read_ones<int>(line, dim);
+    arow.stats().record_parse(timer.elapsed());
     arow.update(data.second, data.first);
   }
 
@@ -48,6 +51,7 @@ int main(const int ac, const char* const * const av) {
     ++all;
   }
 
+  std::cout << arow.stats() << std::endl;
   std::cout << "Accuracy = " << (100.0 * collect / all) << "% (" << collect << "/" << all << ")" << std::endl;
 
   return 0;
@@ -0,0 +1,70 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/feature.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <iostream>
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "評価データのファイルパス")
+    ("namespace", value<std::vector<std::string>>()->multitoken(), "名前空間の特徴番号の範囲 (first-last, 例 : 1-10 11-20)")
+    ("cross", value<std::vector<std::string>>()->multitoken(), "掛け合わせる名前空間の組 (a,b, 例 : 0,1)")
+    ("buckets", value<std::size_t>()->default_value(1 << 16), "交差特徴をハッシュする次元数")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) { std::cout << description << std::endl; }
+
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto train_path = vm["train"].as<std::string>();
+  const auto test_path = vm["test"].as<std::string>();
+  const auto r = vm["r"].as<double>();
+
+  feature::QuadraticCrosses crosses(dim, vm["buckets"].as<std::size_t>());
+  if (vm.count("namespace")) {
+    for (const auto& range : vm["namespace"].as<std::vector<std::string>>()) {
+      const auto pos = range.find('-');
+      crosses.add_namespace(std::stoul(range.substr(0, pos)), std::stoul(range.substr(pos + 1)));
+    }
+  }
+  if (vm.count("cross")) {
+    for (const auto& pair : vm["cross"].as<std::vector<std::string>>()) {
+      const auto pos = pair.find(',');
+      crosses.cross(std::stoul(pair.substr(0, pos)), std::stoul(pair.substr(pos + 1)));
+    }
+  }
+  auto arow = feature::make_expanded(crosses, AROW(crosses.output_dim(), r));
+
+  std::string line;
+  std::ifstream train_data(train_path);
+  std::cout << "training..." << std::endl;
+  while(std::getline(train_data, line)) {
+    auto data = utility::read_ones<int>(line, dim);
+    arow.update(data.second, data.first);
+  }
+
+  auto collect = 0;
+  auto all = 0;
+  std::ifstream test_data(test_path);
+  std::cout << "predicting..." << std::endl;
+  while(std::getline(test_data, line)) {
+    auto data = utility::read_ones<int>(line, dim);
+    if(arow.predict(data.second) == data.first) {
+      ++collect;
+    }
+    ++all;
+  }
+
+  std::cout << "Accuracy = " << (100.0 * collect / all) << "% (" << collect << "/" << all << ")" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,59 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/feature.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <iostream>
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "評価データのファイルパス")
+    ("components", value<std::size_t>()->default_value(512), "ランダム特徴の数 (学習器の次元数はこの2倍)")
+    ("gamma", value<double>()->default_value(1.0), "RBFカーネルのパラメータ(gamma)")
+    ("seed", value<unsigned int>()->default_value(1), "射影行列の乱数シード")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) { std::cout << description << std::endl; }
+
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto train_path = vm["train"].as<std::string>();
+  const auto test_path = vm["test"].as<std::string>();
+  const auto r = vm["r"].as<double>();
+
+  feature::RandomFourierFeatures map(dim, vm["components"].as<std::size_t>(), vm["gamma"].as<double>(),
+                                     vm["seed"].as<unsigned int>());
+  auto arow = feature::make_expanded(map, AROW(map.output_dim(), r));
+
+  std::string line;
+  std::ifstream train_data(train_path);
+  std::cout << "training..." << std::endl;
+  while(std::getline(train_data, line)) {
+    auto data = utility::read_ones<int>(line, dim);
+    arow.update(data.second, data.first);
+  }
+
+  auto collect = 0;
+  auto all = 0;
+  std::ifstream test_data(test_path);
+  std::cout << "predicting..." << std::endl;
+  while(std::getline(test_data, line)) {
+    auto data = utility::read_ones<int>(line, dim);
+    if(arow.predict(data.second) == data.first) {
+      ++collect;
+    }
+    ++all;
+  }
+
+  std::cout << "Accuracy = " << (100.0 * collect / all) << "% (" << collect << "/" << all << ")" << std::endl;
+
+  return 0;
+}
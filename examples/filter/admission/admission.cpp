@@ -0,0 +1,65 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/filter.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <iostream>
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "評価データのファイルパス")
+    ("min-count", value<std::uint32_t>()->default_value(3), "特徴を採用するまでの出現回数")
+    ("budget", value<std::size_t>()->default_value(0), "採用する特徴数の上限 (0 : 上限なし)")
+    ("width", value<std::size_t>()->default_value(1 << 20), "Count-Min sketch の幅")
+    ("depth", value<std::size_t>()->default_value(4), "Count-Min sketch の深さ")
+    ("decay", value<std::uint64_t>()->default_value(0), "出現回数を半減させる事例数の間隔 (0 : 減衰なし)")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) { std::cout << description << std::endl; }
+
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto train_path = vm["train"].as<std::string>();
+  const auto test_path = vm["test"].as<std::string>();
+  const auto r = vm["r"].as<double>();
+
+  filter::FeatureAdmission admission(vm["min-count"].as<std::uint32_t>(), vm["budget"].as<std::size_t>(),
+                                     vm["width"].as<std::size_t>(), vm["depth"].as<std::size_t>(),
+                                     vm["decay"].as<std::uint64_t>());
+  auto arow = filter::make_admitted(admission, AROW(dim, r));
+
+  std::string line;
+  std::ifstream train_data(train_path);
+  std::cout << "training..." << std::endl;
+  while(std::getline(train_data, line)) {
+    auto data = utility::read_ones<int>(line, dim);
+    arow.update(data.second, data.first);
+  }
+  std::cout << "admitted = " << arow.admission().size() << ", filtered = " << arow.admission().filtered()
+            << ", evicted = " << arow.admission().evicted()
+            << ", filter memory = " << arow.admission().memory_bytes() << " bytes" << std::endl;
+
+  auto collect = 0;
+  auto all = 0;
+  std::ifstream test_data(test_path);
+  std::cout << "predicting..." << std::endl;
+  while(std::getline(test_data, line)) {
+    auto data = utility::read_ones<int>(line, dim);
+    if(arow.predict(data.second) == data.first) {
+      ++collect;
+    }
+    ++all;
+  }
+
+  std::cout << "Accuracy = " << (100.0 * collect / all) << "% (" << collect << "/" << all << ")" << std::endl;
+
+  return 0;
+}
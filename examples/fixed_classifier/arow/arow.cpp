@@ -0,0 +1,65 @@
+#include <mochimochi/fixed_classifier.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iostream>
+
+#ifndef FIXED_DIM
+#define FIXED_DIM 50
+#endif
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+  constexpr int kDim = FIXED_DIM;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "評価データのファイルパス")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) { std::cout << description << std::endl; }
+
+  const auto train_path = vm["train"].as<std::string>();
+  const auto test_path = vm["test"].as<std::string>();
+  const auto r = vm["r"].as<double>();
+
+  std::string line;
+  std::ifstream train_data(train_path);
+
+  fixed::AROW<kDim> arow(r);
+
+  std::cout << "training... (dim = " << kDim << ")" << std::endl;
+  auto elapsed = 0.0;
+  auto count = 0;
+  while(std::getline(train_data, line)) {
+    const auto data = utility::read_ones<int>(line, kDim);
+    const fixed::AROW<kDim>::Vector x = data.second;
+    const auto start = std::chrono::steady_clock::now();
+    arow.update(x, data.first);
+    elapsed += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    ++count;
+  }
+  std::cout << "update = " << (elapsed / count) << " ns" << std::endl;
+
+  auto collect = 0;
+  auto all = 0;
+  std::ifstream test_data(test_path);
+  std::cout << "predicting..." << std::endl;
+  while(std::getline(test_data, line)) {
+    auto data = utility::read_ones<int>(line, kDim);
+    if(arow.predict(data.second) == data.first) {
+      ++collect;
+    }
+    ++all;
+  }
+
+  std::cout << "Accuracy = " << (100.0 * collect / all) << "% (" << collect << "/" << all << ")" << std::endl;
+
+  return 0;
+}
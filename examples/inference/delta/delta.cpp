@@ -0,0 +1,99 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/multi_classifier.hpp>
+#include <mochimochi/inference.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <iostream>
+
+template <typename Label, class Learner>
+void run(Learner learner, const std::size_t dim, std::ifstream& train_data,
+         const std::vector<Eigen::VectorXd>& samples, const std::size_t chunk, const std::string& path) {
+  auto tracked = inference::make_tracked(std::move(learner), dim);
+  auto f32 = inference::freeze<float>(tracked.learner());
+  auto i8 = inference::freeze<std::int8_t>(tracked.learner());
+  tracked.checkpoint();
+
+  std::size_t deltas = 0;
+  std::size_t delta_bytes = 0;
+  const auto ship = [&]() {
+    tracked.export_delta().save(path);
+    const auto delta = inference::ModelDelta::load(path);
+    f32.apply(delta);
+    i8.apply(delta);
+    ++deltas;
+    delta_bytes += delta.bytes();
+    std::cout << "delta " << delta.sequence() << " : " << delta.size() << " features, "
+              << delta.bytes() << " bytes" << std::endl;
+  };
+
+  std::string line;
+  std::size_t count = 0;
+  while(std::getline(train_data, line)) {
+    const auto data = utility::read_ones<Label>(line, dim);
+    tracked.update(data.second, data.first);
+    if (++count % chunk == 0) { ship(); }
+  }
+  if (tracked.changed() > 0) { ship(); }
+
+  const auto f32_report = inference::check_accuracy(tracked.learner(), f32, samples);
+  const auto i8_report = inference::check_accuracy(tracked.learner(), i8, samples);
+  const auto i8_fresh = inference::check_accuracy(tracked.learner(), inference::freeze<std::int8_t>(tracked.learner()), samples);
+  std::cout << "full model : " << f32.memory_bytes() << " bytes (float32), "
+            << deltas << " deltas : " << (deltas == 0 ? 0 : delta_bytes / deltas) << " bytes on average" << std::endl;
+  std::cout << "float32 : agreement = " << 100.0 * f32_report.agreement()
+            << "%, max score error = " << f32_report.max_score_error << std::endl;
+  std::cout << "int8    : agreement = " << 100.0 * i8_report.agreement()
+            << "%, max score error = " << i8_report.max_score_error
+            << " (fresh freeze : " << i8_fresh.max_score_error << ")" << std::endl;
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("class", value<std::size_t>()->default_value(0), "クラス数 (0 : 二値分類)")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "評価データのファイルパス")
+    ("chunk", value<std::size_t>()->default_value(1000), "差分を出力する間隔 (事例数)")
+    ("delta", value<std::string>()->default_value("model.delta"), "差分の出力先")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto n_class = vm["class"].as<std::size_t>();
+  const auto chunk = std::max<std::size_t>(1, vm["chunk"].as<std::size_t>());
+  const auto path = vm["delta"].as<std::string>();
+  const auto r = vm["r"].as<double>();
+
+  std::string line;
+  std::vector<Eigen::VectorXd> samples;
+  std::ifstream test_data(vm["test"].as<std::string>());
+  while(std::getline(test_data, line)) {
+    samples.push_back(utility::read_ones<int>(line, dim).second);
+  }
+
+  std::ifstream train_data(vm["train"].as<std::string>());
+  try {
+    if (n_class == 0) {
+      run<int>(AROW(dim, r), dim, train_data, samples, chunk, path);
+    } else {
+      run<std::size_t>(MCAROW(dim, n_class, r), dim, train_data, samples, chunk, path);
+    }
+  } catch (const std::runtime_error& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/multi_classifier.hpp>
+#include <mochimochi/inference.hpp>
+#include <mochimochi/serving.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iostream>
+
+template <class Model>
+double measure(const Model& model, const std::vector<Eigen::VectorXd>& samples) {
+  const auto start = std::chrono::steady_clock::now();
+  volatile int sink = 0;
+  for (const auto& x : samples) { sink = sink + model.predict(x); }
+  const auto end = std::chrono::steady_clock::now();
+  return samples.size() / std::chrono::duration<double>(end - start).count();
+}
+
+template <class Learner>
+void report(const Learner& learner, const std::vector<Eigen::VectorXd>& samples, const std::string& output,
+            const std::string& publish) {
+  const auto f32 = inference::freeze<float>(learner);
+  const auto i8 = inference::freeze<std::int8_t>(learner);
+  const auto f32_report = inference::check_accuracy(learner, f32, samples);
+  const auto i8_report = inference::check_accuracy(learner, i8, samples);
+
+  std::cout << "double  : " << measure(learner, samples) << " predictions/sec" << std::endl;
+  std::cout << "float32 : " << f32.memory_bytes() << " bytes, agreement = " << 100.0 * f32_report.agreement()
+            << "%, max score error = " << f32_report.max_score_error << ", "
+            << measure(f32, samples) << " predictions/sec" << std::endl;
+  std::cout << "int8    : " << i8.memory_bytes() << " bytes, agreement = " << 100.0 * i8_report.agreement()
+            << "%, max score error = " << i8_report.max_score_error << ", "
+            << measure(i8, samples) << " predictions/sec" << std::endl;
+
+  if (!output.empty()) {
+    f32.save(output + ".f32");
+    i8.save(output + ".i8");
+  }
+
+  if (!publish.empty()) {
+    serving::ModelPublisher<float> publisher(publish);
+    std::cout << "published " << publish << " generation " << publisher.publish(f32) << std::endl;
+  }
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("class", value<std::size_t>()->default_value(0), "クラス数 (0 : 二値分類)")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "評価データのファイルパス")
+    ("output", value<std::string>()->default_value(""), "推論専用モデルの出力先 (<output>.f32, <output>.i8)")
+    ("publish", value<std::string>()->default_value(""), "float32 モデルを公開する共有ファイルのプレフィックス (例 : /dev/shm/model)")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) { std::cout << description << std::endl; }
+
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto n_class = vm["class"].as<std::size_t>();
+  const auto train_path = vm["train"].as<std::string>();
+  const auto test_path = vm["test"].as<std::string>();
+  const auto output = vm["output"].as<std::string>();
+  const auto publish = vm["publish"].as<std::string>();
+  const auto r = vm["r"].as<double>();
+
+  std::string line;
+  std::vector<Eigen::VectorXd> samples;
+  std::ifstream test_data(test_path);
+  while(std::getline(test_data, line)) {
+    samples.push_back(utility::read_ones<int>(line, dim).second);
+  }
+
+  std::ifstream train_data(train_path);
+  std::cout << "training..." << std::endl;
+  if (n_class == 0) {
+    AROW arow(dim, r);
+    while(std::getline(train_data, line)) {
+      const auto data = utility::read_ones<int>(line, dim);
+      arow.update(data.second, data.first);
+    }
+    report(arow, samples, output, publish);
+  } else {
+    MCAROW mcarow(dim, n_class, r);
+    while(std::getline(train_data, line)) {
+      const auto data = utility::read_ones<std::size_t>(line, dim);
+      mcarow.update(data.second, data.first);
+    }
+    report(mcarow, samples, output, publish);
+  }
+
+  return 0;
+}
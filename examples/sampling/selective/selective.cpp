@@ -0,0 +1,73 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/sampling.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <iostream>
+
+template <class Learner>
+void run(Learner learner, const sampling::Rule rule, const double threshold,
+         const std::string& train_path, const std::string& test_path, const std::size_t dim) {
+  auto sampler = sampling::make_selective_sampler(rule, threshold, learner);
+
+  std::string line;
+  std::ifstream train_data(train_path);
+  std::cout << "training..." << std::endl;
+  while(std::getline(train_data, line)) {
+    auto data = utility::read_ones<int>(line, dim);
+    sampler.update(data.second, data.first);
+  }
+  std::cout << "queried = " << sampler.queried() << ", skipped = " << sampler.skipped()
+            << " (query rate = " << 100.0 * sampler.query_rate() << "%)" << std::endl;
+
+  auto collect = 0;
+  auto all = 0;
+  std::ifstream test_data(test_path);
+  std::cout << "predicting..." << std::endl;
+  while(std::getline(test_data, line)) {
+    auto data = utility::read_ones<int>(line, dim);
+    if(sampler.predict(data.second) == data.first) {
+      ++collect;
+    }
+    ++all;
+  }
+
+  std::cout << "Accuracy = " << (100.0 * collect / all) << "% (" << collect << "/" << all << ")" << std::endl;
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("algorithm", value<std::string>()->default_value("arow"), "アルゴリズム (arow, scw)")
+    ("rule", value<std::string>()->default_value("margin"), "選択規則 (margin, probabilistic)")
+    ("threshold", value<double>()->default_value(1.0), "選択規則の閾値")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "評価データのファイルパス")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)")
+    ("c", value<double>()->default_value(1.0), "ハイパパラメータ(c)")
+    ("eta", value<double>()->default_value(0.95), "ハイパパラメータ(η)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) { std::cout << description << std::endl; }
+
+  const auto algorithm = vm["algorithm"].as<std::string>();
+  const auto rule = vm["rule"].as<std::string>() == "probabilistic" ? sampling::Rule::kProbabilistic : sampling::Rule::kMargin;
+  const auto threshold = vm["threshold"].as<double>();
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto train_path = vm["train"].as<std::string>();
+  const auto test_path = vm["test"].as<std::string>();
+
+  if (algorithm == "scw") {
+    run(SCW(dim, vm["c"].as<double>(), vm["eta"].as<double>()), rule, threshold, train_path, test_path, dim);
+  } else {
+    run(AROW(dim, vm["r"].as<double>()), rule, threshold, train_path, test_path, dim);
+  }
+
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include <boost/program_options.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <vector>
+#include "./protocol.hpp"
+
+namespace {
+  struct Query {
+    int label;
+    std::string text;
+    std::string binary;
+  };
+
+  int connect_to(const std::string& socket_path) {
+    const auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    socket_path.copy(address.sun_path, std::min(socket_path.size(), sizeof(address.sun_path) - 1));
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+      if (fd >= 0) { ::close(fd); }
+      return -1;
+    }
+    return fd;
+  }
+
+  // one request / response round trip, returns the predicted label (0 on failure)
+  int ask(const int fd, protocol::Reader& reader, const Query& query, const bool binary) {
+    if (binary) {
+      std::int32_t label;
+      double score;
+      if (!protocol::write_all(fd, query.binary.data(), query.binary.size()) ||
+          !reader.read(&label, sizeof(label)) || !reader.read(&score, sizeof(score))) { return 0; }
+      return label;
+    }
+
+    std::string line;
+    if (!protocol::write_all(fd, query.text.data(), query.text.size()) || !reader.read_line(line)) { return 0; }
+    return std::atoi(line.c_str());
+  }
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("socket", value<std::string>()->default_value("/tmp/mochimochi.sock"), "Unix domain socket のパス")
+    ("data", value<std::string>()->default_value(""), "送信するデータ (svmlight 形式) のファイルパス")
+    ("connections", value<std::size_t>()->default_value(8), "同時接続数")
+    ("requests", value<std::size_t>()->default_value(100000), "接続あたりのリクエスト数")
+    ("binary", "バイナリ形式で送信する");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  const auto socket_path = vm["socket"].as<std::string>();
+  const auto connections = vm["connections"].as<std::size_t>();
+  const auto requests = vm["requests"].as<std::size_t>();
+  const auto binary = vm.count("binary") > 0;
+
+  std::vector<Query> queries;
+  std::ifstream ifs(vm["data"].as<std::string>());
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.empty()) { continue; }
+    const auto feature = protocol::parse_text(line);
+    queries.push_back(Query { std::atoi(line.c_str()), line + "\n", protocol::encode_binary(feature) });
+  }
+  if (queries.empty()) {
+    std::cerr << "No data : " << vm["data"].as<std::string>() << std::endl;
+    return 1;
+  }
+
+  std::vector<std::vector<double>> latencies(connections);
+  std::atomic<std::size_t> agreed(0);
+  std::atomic<std::size_t> failed(0);
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> clients;
+  for (std::size_t c = 0; c < connections; ++c) {
+    clients.emplace_back([&, c]() {
+        const auto fd = connect_to(socket_path);
+        if (fd < 0) { failed += requests; return; }
+        protocol::Reader reader(fd);
+        latencies[c].reserve(requests);
+        for (std::size_t i = 0; i < requests; ++i) {
+          const auto& query = queries[(c * requests + i) % queries.size()];
+          const auto t0 = std::chrono::steady_clock::now();
+          const auto label = ask(fd, reader, query, binary);
+          const auto t1 = std::chrono::steady_clock::now();
+          if (label == 0) { failed += requests - i; break; }
+          latencies[c].push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+          if (label == query.label) { ++agreed; }
+        }
+        ::close(fd);
+      });
+  }
+  for (auto& client : clients) { client.join(); }
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<double> all;
+  for (const auto& l : latencies) { all.insert(all.end(), l.begin(), l.end()); }
+  if (all.empty()) {
+    std::cerr << "No response from " << socket_path << std::endl;
+    return 1;
+  }
+  std::sort(all.begin(), all.end());
+  const auto percentile = [&](const double p) { return all[std::min(all.size() - 1, static_cast<std::size_t>(p * all.size()))]; };
+
+  std::cout << "requests=" << all.size()
+            << " failed=" << failed
+            << " requests_per_sec=" << all.size() / seconds
+            << " p50_us=" << percentile(0.50)
+            << " p99_us=" << percentile(0.99)
+            << " accuracy=" << static_cast<double>(agreed) / all.size() << std::endl;
+  return 0;
+}
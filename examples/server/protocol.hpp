@@ -0,0 +1,142 @@
+#ifndef MOCHIMOCHI_EXAMPLES_SERVER_PROTOCOL_HPP_
+#define MOCHIMOCHI_EXAMPLES_SERVER_PROTOCOL_HPP_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+// Requests are either a svmlight line ("[label] index:value ...\n", the label is ignored)
+// answered by "<label> <score>\n", or a binary frame
+//   uint8 kBinaryMagic, uint32 nnz, nnz x (uint32 index, float64 value)
+// answered by int32 label, float64 score (native byte order, indices start at 1).
+// The server closes the connection on a frame whose nnz exceeds the model dimension.
+namespace protocol {
+
+  constexpr std::uint8_t kBinaryMagic = 0x01;
+
+  using SparseFeature = std::vector<std::pair<std::uint32_t, double>>;
+
+  inline SparseFeature parse_text(const std::string& line) {
+    SparseFeature feature;
+    std::istringstream iss(line);
+    std::string token;
+    while (iss >> token) {
+      const auto pos = token.find(':');
+      if (pos == std::string::npos) { continue; }
+      feature.emplace_back(std::stoul(token.substr(0, pos)), std::stod(token.substr(pos + 1)));
+    }
+    return feature;
+  }
+
+  inline bool read_exact(const int fd, void* buffer, std::size_t size) {
+    auto p = static_cast<char*>(buffer);
+    while (size > 0) {
+      const auto n = ::read(fd, p, size);
+      if (n < 0 && errno == EINTR) { continue; }
+      if (n <= 0) { return false; }
+      p += n;
+      size -= n;
+    }
+    return true;
+  }
+
+  inline bool write_all(const int fd, const void* buffer, std::size_t size) {
+    auto p = static_cast<const char*>(buffer);
+    while (size > 0) {
+      const auto n = ::write(fd, p, size);
+      if (n < 0 && errno == EINTR) { continue; }
+      if (n <= 0) { return false; }
+      p += n;
+      size -= n;
+    }
+    return true;
+  }
+
+  // buffered reads of lines and binary frames from a socket
+  class Reader {
+  private :
+    const int kFd;
+
+  private :
+    std::vector<char> _buffer;
+    std::size_t _begin;
+    std::size_t _end;
+
+  private :
+    bool fill(void) {
+      if (_begin == _end) { _begin = _end = 0; }
+      if (_end == _buffer.size()) {
+        if (_begin == 0) { _buffer.resize(_buffer.size() * 2); }
+        else {
+          std::copy(_buffer.begin() + _begin, _buffer.begin() + _end, _buffer.begin());
+          _end -= _begin;
+          _begin = 0;
+        }
+      }
+      while (true) {
+        const auto n = ::read(kFd, _buffer.data() + _end, _buffer.size() - _end);
+        if (n < 0 && errno == EINTR) { continue; }
+        if (n <= 0) { return false; }
+        _end += n;
+        return true;
+      }
+    }
+
+  public :
+    explicit Reader(const int fd) : kFd(fd), _buffer(1 << 16), _begin(0), _end(0) { }
+
+    bool peek(std::uint8_t& byte) {
+      if (_begin == _end && !fill()) { return false; }
+      byte = static_cast<std::uint8_t>(_buffer[_begin]);
+      return true;
+    }
+
+    bool read(void* out, std::size_t size) {
+      auto p = static_cast<char*>(out);
+      while (size > 0) {
+        if (_begin == _end && !fill()) { return false; }
+        const auto n = std::min(size, _end - _begin);
+        std::copy(_buffer.begin() + _begin, _buffer.begin() + _begin + n, p);
+        _begin += n;
+        p += n;
+        size -= n;
+      }
+      return true;
+    }
+
+    bool read_line(std::string& line) {
+      line.clear();
+      while (true) {
+        for (auto i = _begin; i < _end; ++i) {
+          if (_buffer[i] == '\n') {
+            line.append(_buffer.begin() + _begin, _buffer.begin() + i);
+            _begin = i + 1;
+            return true;
+          }
+        }
+        line.append(_buffer.begin() + _begin, _buffer.begin() + _end);
+        _begin = _end;
+        if (!fill()) { return false; }
+      }
+    }
+  };
+
+  inline std::string encode_binary(const SparseFeature& feature) {
+    std::string frame(1, static_cast<char>(kBinaryMagic));
+    const std::uint32_t nnz = feature.size();
+    frame.append(reinterpret_cast<const char*>(&nnz), sizeof(nnz));
+    for (const auto& p : feature) {
+      frame.append(reinterpret_cast<const char*>(&p.first), sizeof(p.first));
+      frame.append(reinterpret_cast<const char*>(&p.second), sizeof(p.second));
+    }
+    return frame;
+  }
+
+};
+
+#endif //MOCHIMOCHI_EXAMPLES_SERVER_PROTOCOL_HPP_
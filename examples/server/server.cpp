@@ -0,0 +1,275 @@
+#include <mochimochi/inference.hpp>
+#include <mochimochi/serving.hpp>
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <csignal>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "./protocol.hpp"
+
+namespace {
+  std::atomic<bool> stopping(false);
+
+  void on_signal(int) { stopping = true; }
+
+  struct Response {
+    int label;
+    double score;
+  };
+
+  std::int64_t modified_time(const std::string& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) { return -1; }
+    return static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+  }
+
+  bool is_float_model(const std::string& path, const std::string& shared) {
+    try {
+      if (shared.empty()) {
+        inference::FrozenModel<float>::load(path);
+      } else {
+        serving::SharedModel<float> model(shared);
+      }
+      return true;
+    } catch (const std::runtime_error&) {
+      return false;
+    }
+  }
+}
+
+template <typename T>
+class Server {
+private :
+  using Model = inference::FrozenModel<T>;
+
+private :
+  std::shared_ptr<const Model> _model;
+  serving::MicroBatcher<protocol::SparseFeature, Response> _batcher;
+
+public :
+  Server(std::shared_ptr<const Model> model, const std::size_t workers, const std::size_t max_batch,
+         const std::chrono::microseconds max_delay)
+    : _model(std::move(model)),
+      _batcher([this](const std::vector<protocol::SparseFeature>& requests, std::vector<Response>& responses) {
+                 score(requests, responses);
+               }, workers, max_batch, max_delay) { }
+
+private :
+
+  void score(const std::vector<protocol::SparseFeature>& requests, std::vector<Response>& responses) const {
+    const auto model = std::atomic_load(&_model);
+    const auto dim = model->dimension();
+    std::vector<Eigen::VectorXd> xs(requests.size(), Eigen::VectorXd::Zero(dim));
+    for (std::size_t b = 0; b < requests.size(); ++b) {
+      for (const auto& p : requests[b]) {
+        if (p.first >= 1 && p.first <= dim) { xs[b][p.first - 1] = p.second; }
+      }
+    }
+
+    const Eigen::MatrixXd scores = model->compute_scores(xs);
+    for (std::size_t b = 0; b < requests.size(); ++b) {
+      const auto label = model->predict_from_scores(scores.col(b));
+      const auto row = (model->n_class() == 1) ? 0 : label - 1;
+      responses.push_back(Response { label, scores(row, b) });
+    }
+  }
+
+public :
+
+  // requests already batched keep the model they started with
+  void swap(std::shared_ptr<const Model> model) {
+    std::atomic_store(&_model, std::move(model));
+  }
+
+  // the caller owns fd and closes it once serve returned
+  void serve(const int fd) {
+    protocol::Reader reader(fd);
+    std::string line;
+    std::uint8_t first;
+    while (reader.peek(first)) {
+      if (first == protocol::kBinaryMagic) {
+        std::uint8_t magic;
+        std::uint32_t nnz;
+        if (!reader.read(&magic, sizeof(magic)) || !reader.read(&nnz, sizeof(nnz))) { break; }
+        // checked before allocating : a frame cannot name more features than the model has
+        if (nnz > std::atomic_load(&_model)->dimension()) { break; }
+        protocol::SparseFeature feature(nnz);
+        auto ok = true;
+        for (auto& p : feature) {
+          ok = ok && reader.read(&p.first, sizeof(p.first)) && reader.read(&p.second, sizeof(p.second));
+        }
+        if (!ok) { break; }
+
+        const auto response = _batcher.submit(std::move(feature)).get();
+        const std::int32_t label = response.label;
+        if (!protocol::write_all(fd, &label, sizeof(label)) ||
+            !protocol::write_all(fd, &response.score, sizeof(response.score))) { break; }
+      } else {
+        if (!reader.read_line(line)) { break; }
+        protocol::SparseFeature feature;
+        try {
+          feature = protocol::parse_text(line);
+        } catch (const std::exception&) {
+          const std::string error = "error\n";
+          if (!protocol::write_all(fd, error.data(), error.size())) { break; }
+          continue;
+        }
+
+        const auto response = _batcher.submit(std::move(feature)).get();
+        const auto reply = std::to_string(response.label) + " " + std::to_string(response.score) + "\n";
+        if (!protocol::write_all(fd, reply.data(), reply.size())) { break; }
+      }
+    }
+  }
+};
+
+// one client : shut down when the server stops, joined before the server is destroyed
+struct Connection {
+  int fd;
+  std::atomic<bool> done;
+  std::thread thread;
+
+  explicit Connection(const int fd) : fd(fd), done(false) { }
+};
+
+// the model comes from a file reloaded when it changes, or from a publication (serving::ModelPublisher)
+template <typename T>
+int run(const std::string& model_path, const std::string& shared_prefix, const std::string& socket_path,
+        const std::size_t workers, const std::size_t max_batch, const std::chrono::microseconds max_delay,
+        const int reload_ms) {
+  using Model = inference::FrozenModel<T>;
+  std::unique_ptr<serving::SharedModel<T>> shared;
+  std::shared_ptr<const Model> model;
+  if (shared_prefix.empty()) {
+    model = std::make_shared<const Model>(Model::load(model_path));
+  } else {
+    shared.reset(new serving::SharedModel<T>(shared_prefix));
+    model = shared->get();
+    if (!model) { throw std::runtime_error("No model published yet : " + shared_prefix); }
+  }
+  Server<T> server(model, workers, max_batch, max_delay);
+
+  const auto listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (listener < 0 || socket_path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Cannot create the socket : " << socket_path << std::endl;
+    return 1;
+  }
+  socket_path.copy(address.sun_path, socket_path.size());
+  ::unlink(socket_path.c_str());
+  if (::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listener, 128) != 0) {
+    std::cerr << "Cannot listen on " << socket_path << std::endl;
+    return 1;
+  }
+  std::cout << "listening on " << socket_path << std::endl;
+
+  std::list<Connection> connections;
+  auto last_modified = modified_time(model_path);
+  auto last_check = std::chrono::steady_clock::now();
+  while (!stopping) {
+    pollfd fds = { listener, POLLIN, 0 };
+    if (::poll(&fds, 1, 100) > 0) {
+      const auto fd = ::accept(listener, nullptr, nullptr);
+      if (fd >= 0) {
+        connections.emplace_back(fd);
+        auto& connection = connections.back();
+        // a bad client only loses its own connection
+        connection.thread = std::thread([&server, &connection]() {
+                                          try {
+                                            server.serve(connection.fd);
+                                          } catch (const std::exception& e) {
+                                            std::cerr << "connection closed : " << e.what() << std::endl;
+                                          }
+                                          connection.done = true;
+                                        });
+      }
+    }
+    for (auto it = connections.begin(); it != connections.end();) {
+      if (!it->done) { ++it; continue; }
+      it->thread.join();
+      ::close(it->fd);
+      it = connections.erase(it);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (reload_ms > 0 && now - last_check >= std::chrono::milliseconds(reload_ms)) {
+      last_check = now;
+      if (shared) {
+        if (shared->refresh()) {
+          server.swap(shared->get());
+          std::cout << "switched to generation " << shared->generation() << std::endl;
+        }
+      } else {
+        const auto modified = modified_time(model_path);
+        if (modified != last_modified && modified >= 0) {
+          last_modified = modified;
+          try {
+            server.swap(std::make_shared<const Model>(Model::load(model_path)));
+            std::cout << "reloaded " << model_path << std::endl;
+          } catch (const std::runtime_error& e) {
+            std::cerr << "reload failed, keeping the current model : " << e.what() << std::endl;
+          }
+        }
+      }
+    }
+  }
+
+  ::close(listener);
+  ::unlink(socket_path.c_str());
+  for (auto& connection : connections) { ::shutdown(connection.fd, SHUT_RDWR); }
+  for (auto& connection : connections) {
+    connection.thread.join();
+    ::close(connection.fd);
+  }
+  return 0;
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("model", value<std::string>()->default_value(""), "推論専用モデル (FrozenModel::save) のファイルパス")
+    ("shared", value<std::string>()->default_value(""), "ModelPublisher で公開されたモデルのプレフィックス (指定時は --model の代わりに使う)")
+    ("socket", value<std::string>()->default_value("/tmp/mochimochi.sock"), "Unix domain socket のパス")
+    ("workers", value<std::size_t>()->default_value(std::max(1u, std::thread::hardware_concurrency())), "推論スレッド数")
+    ("batch", value<std::size_t>()->default_value(64), "バッチの最大事例数")
+    ("delay", value<std::size_t>()->default_value(200), "バッチを待つ最大時間 (マイクロ秒)")
+    ("reload", value<int>()->default_value(1000), "モデルの更新を確認する間隔 (ミリ秒, 0 : 確認しない)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  std::signal(SIGINT, on_signal);
+  std::signal(SIGTERM, on_signal);
+  std::signal(SIGPIPE, SIG_IGN);
+
+  const auto model_path = vm["model"].as<std::string>();
+  const auto shared = vm["shared"].as<std::string>();
+  const auto socket_path = vm["socket"].as<std::string>();
+  const auto workers = vm["workers"].as<std::size_t>();
+  const auto batch = vm["batch"].as<std::size_t>();
+  const auto delay = std::chrono::microseconds(vm["delay"].as<std::size_t>());
+  const auto reload = vm["reload"].as<int>();
+
+  try {
+    return is_float_model(model_path, shared) ? run<float>(model_path, shared, socket_path, workers, batch, delay, reload)
+                                              : run<std::int8_t>(model_path, shared, socket_path, workers, batch, delay, reload);
+  } catch (const std::runtime_error& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
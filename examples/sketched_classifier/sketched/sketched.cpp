@@ -0,0 +1,79 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/sketched_classifier.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iostream>
+
+template <class Learner>
+void run(const std::string& name, Learner learner, const std::vector<std::pair<int, Eigen::VectorXd>>& train,
+         const std::vector<std::pair<int, Eigen::VectorXd>>& test) {
+  const auto start = std::chrono::steady_clock::now();
+  for (const auto& data : train) { learner.update(data.second, data.first); }
+  const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+  auto collect = 0;
+  for (const auto& data : test) {
+    if (learner.predict(data.second) == data.first) { ++collect; }
+  }
+  std::cout << name << " : update = " << (elapsed / train.size()) << " us, Accuracy = "
+            << (100.0 * collect / test.size()) << "% (" << collect << "/" << test.size() << ")" << std::endl;
+}
+
+std::vector<std::pair<int, Eigen::VectorXd>> read(const std::string& path, const std::size_t dim) {
+  std::vector<std::pair<int, Eigen::VectorXd>> examples;
+  std::ifstream ifs(path);
+  std::string line;
+  while(std::getline(ifs, line)) {
+    if (!line.empty()) { examples.push_back(utility::read_ones<int>(line, dim)); }
+  }
+  return examples;
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("algorithm", value<std::string>()->default_value("arow"), "学習アルゴリズム (arow, scw)")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "評価データのファイルパス")
+    ("rank", value<std::size_t>()->default_value(8), "共分散の低ランク部分のランク")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)")
+    ("c", value<double>()->default_value(1.0), "ハイパパラメータ(c)")
+    ("eta", value<double>()->default_value(0.9), "ハイパパラメータ(eta)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  const auto algorithm = vm["algorithm"].as<std::string>();
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto rank = vm["rank"].as<std::size_t>();
+  const auto r = vm["r"].as<double>();
+  const auto c = vm["c"].as<double>();
+  const auto eta = vm["eta"].as<double>();
+
+  const auto train = read(vm["train"].as<std::string>(), dim);
+  const auto test = read(vm["test"].as<std::string>(), dim);
+
+  if (algorithm == "arow") {
+    run("diagonal", AROW(dim, r), train, test);
+    run("sketched", sketched::AROW(dim, rank, r), train, test);
+  } else if (algorithm == "scw") {
+    run("diagonal", SCW(dim, c, eta), train, test);
+    run("sketched", sketched::SCW(dim, rank, c, eta), train, test);
+  } else {
+    std::cerr << "Unknown algorithm : " << algorithm << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
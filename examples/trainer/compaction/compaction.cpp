@@ -0,0 +1,100 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+using Examples = std::vector<std::pair<int, Eigen::VectorXd>>;
+
+Examples read(const std::string& path, const std::size_t dim) {
+  Examples examples;
+  std::ifstream ifs(path);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.empty()) { continue; }
+    examples.push_back(utility::read_ones<int>(line, dim));
+  }
+  return examples;
+}
+
+template <class Learner>
+double accuracy(const Learner& learner, const Examples& test) {
+  std::size_t correct = 0;
+  for (const auto& example : test) {
+    if (learner.predict(example.second) == example.first) { ++correct; }
+  }
+  return static_cast<double>(correct) / test.size();
+}
+
+// every example learned one by one, then the duplicates collapsed into weighted examples
+template <class Learner, typename... Args>
+void run(const Examples& train, const Examples& test, const std::size_t dim, const std::size_t window, Args&&... args) {
+  Learner plain(args...);
+  auto start = std::chrono::steady_clock::now();
+  for (const auto& example : train) { plain.update(example.second, example.first); }
+  const auto plain_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  Learner compacted(args...);
+  const auto sink = [&](const Eigen::VectorXd& x, const int label, const double weight) {
+    compacted.update(x, label, weight);
+  };
+  utility::DuplicateCompactor<int> compactor(dim, window);
+  start = std::chrono::steady_clock::now();
+  for (const auto& example : train) { compactor.add(example.second, example.first, sink); }
+  compactor.flush(sink);
+  const auto compacted_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << "examples=" << compactor.seen() << " distinct=" << compactor.emitted() << std::endl;
+  std::cout << "every example : seconds=" << plain_seconds << " accuracy=" << accuracy(plain, test) << std::endl;
+  std::cout << "compacted     : seconds=" << compacted_seconds << " accuracy=" << accuracy(compacted, test) << std::endl;
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("algorithm", value<std::string>()->default_value("arow"), "アルゴリズム")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "テストデータのファイルパス")
+    ("window", value<std::size_t>()->default_value(4096), "重複をまとめる異なり事例数")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)")
+    ("c", value<double>()->default_value(1.0), "ハイパパラメータ(c)")
+    ("eta", value<double>()->default_value(0.95), "ハイパパラメータ(η)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  const auto algorithm = vm["algorithm"].as<std::string>();
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto window = vm["window"].as<std::size_t>();
+  const auto r = vm["r"].as<double>();
+  const auto c = vm["c"].as<double>();
+  const auto eta = vm["eta"].as<double>();
+  const auto train = read(vm["train"].as<std::string>(), dim);
+  const auto test = read(vm["test"].as<std::string>(), dim);
+
+  if (algorithm == "arow") { run<AROW>(train, test, dim, window, dim, r); }
+  else if (algorithm == "scw") { run<SCW>(train, test, dim, window, dim, c, eta); }
+  else if (algorithm == "nherd") { run<NHERD>(train, test, dim, window, dim, c); }
+  else if (algorithm == "pa") { run<PA>(train, test, dim, window, dim, c); }
+  else if (algorithm == "adam") { run<ADAM>(train, test, dim, window, dim); }
+  else if (algorithm == "adagrad_rda") { run<ADAGRAD_RDA>(train, test, dim, window, dim, 0.1, 0.000001); }
+  else if (algorithm == "averaged_pa") { run<AVERAGED_PA>(train, test, dim, window, dim, c); }
+  else if (algorithm == "averaged_arow") { run<AVERAGED_AROW>(train, test, dim, window, dim, r); }
+  else {
+    std::cerr << "Unknown algorithm : " << algorithm << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/trainer.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <tuple>
+
+template <class Learner>
+double accuracy(const Learner& learner, const std::string& path, const std::size_t dim) {
+  std::size_t n = 0, correct = 0;
+  std::ifstream test_data(path);
+  std::string line;
+  while (std::getline(test_data, line)) {
+    if (line.empty()) { continue; }
+    const auto data = utility::read_ones<int>(line, dim);
+    if (learner.predict(data.second) == data.first) { ++correct; }
+    ++n;
+  }
+  return n == 0 ? 0.0 : static_cast<double>(correct) / n;
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+  using Clock = trainer::DelayedFeedback<AROW>::Clock;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "評価データのファイルパス")
+    ("delay", value<double>()->default_value(5000.0), "正例のラベルが届くまでの平均時間 (ミリ秒)")
+    ("negative-rate", value<double>()->default_value(0.0), "負例のラベルが届く確率")
+    ("ttl", value<std::size_t>()->default_value(30000), "ラベルを待つ時間 (ミリ秒)")
+    ("capacity", value<std::size_t>()->default_value(100000), "ラベルを待つ予測の最大数")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto r = vm["r"].as<double>();
+  const auto negative_rate = vm["negative-rate"].as<double>();
+  const auto ttl = std::chrono::milliseconds(vm["ttl"].as<std::size_t>());
+
+  trainer::DelayedFeedback<AROW> delayed(vm["capacity"].as<std::size_t>(), ttl, -1, dim, r);
+  trainer::OnlineTrainer<AROW> immediate(dim, r);
+
+  std::mt19937 engine(1);
+  std::exponential_distribution<double> delay(1.0 / vm["delay"].as<double>());
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+  // (arrival in milliseconds, request id, label), earliest first
+  using Label = std::tuple<double, std::uint64_t, int>;
+  std::priority_queue<Label, std::vector<Label>, std::greater<Label>> labels;
+
+  const auto start = Clock::time_point();
+  std::ifstream train_data(vm["train"].as<std::string>());
+  std::string line;
+  std::uint64_t id = 0;
+  while (std::getline(train_data, line)) {
+    if (line.empty()) { continue; }
+    const auto data = utility::read_ones<int>(line, dim);
+    const auto now = static_cast<double>(id);
+    while (!labels.empty() && std::get<0>(labels.top()) <= now) {
+      const auto arrival = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(std::get<0>(labels.top())));
+      delayed.feedback(std::get<1>(labels.top()), std::get<2>(labels.top()), arrival);
+      labels.pop();
+    }
+
+    delayed.predict(id, data.second, start + std::chrono::milliseconds(id));
+    immediate.learn(data.second, data.first);
+    if (data.first > 0) {
+      labels.emplace(now + delay(engine), id, data.first);
+    } else if (uniform(engine) < negative_rate) {
+      labels.emplace(now + delay(engine), id, data.first);
+    }
+    ++id;
+  }
+  while (!labels.empty()) {
+    delayed.feedback(std::get<1>(labels.top()), std::get<2>(labels.top()), start + std::chrono::milliseconds(id));
+    labels.pop();
+  }
+  delayed.flush();
+
+  std::cout << "joined=" << delayed.joined() << " expired=" << delayed.expired() << " evicted=" << delayed.evicted()
+            << " late labels=" << delayed.unknown() << std::endl;
+  std::cout << "delayed   : " << delayed.metrics() << std::endl;
+  std::cout << "immediate : " << immediate.metrics() << std::endl;
+  std::cout << "test accuracy : delayed=" << accuracy(delayed.learner(), vm["test"].as<std::string>(), dim)
+            << " immediate=" << accuracy(immediate.learner(), vm["test"].as<std::string>(), dim) << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/parallel.hpp>
+#include <mochimochi/trainer.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+template <class Learner, typename... Args>
+void run(parallel::Transport& transport, const std::string& train, const std::string& test, const std::size_t dim,
+         const std::size_t interval, Args&&... args) {
+  trainer::DataParallelTrainer<Learner> trainer(transport, interval, std::forward<Args>(args)...);
+
+  const auto start = std::chrono::steady_clock::now();
+  std::ifstream train_data(train);
+  const auto count = trainer.train(train_data, dim);
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if (transport.rank() != 0) { return; }
+  std::cout << "worker 0 : examples=" << count << " rounds=" << trainer.rounds()
+            << " seconds=" << seconds << std::endl;
+  std::cout << "worker 0 progressive : " << trainer.metrics() << std::endl;
+
+  std::size_t n = 0, correct = 0;
+  std::ifstream test_data(test);
+  std::string line;
+  while (std::getline(test_data, line)) {
+    if (line.empty()) { continue; }
+    const auto data = utility::read_ones<int>(line, dim);
+    if (trainer.learner().predict(data.second) == data.first) { ++correct; }
+    ++n;
+  }
+  std::cout << "test accuracy : " << static_cast<double>(correct) / n << std::endl;
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("algorithm", value<std::string>()->default_value("adam"), "アルゴリズム (adam, adagrad_rda, pa)")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "テストデータのファイルパス")
+    ("workers", value<std::size_t>()->default_value(4), "ワーカプロセス数")
+    ("rank", value<int>()->default_value(-1), "このプロセスのランク (指定しない場合は全ワーカを fork する)")
+    ("interval", value<std::size_t>()->default_value(1000), "同期するまでに各ワーカが学習する事例数")
+    ("socket", value<std::string>()->default_value("/tmp/mochimochi.allreduce"), "Unix domain socket のプレフィックス")
+    ("c", value<double>()->default_value(1.0), "ハイパパラメータ(c)")
+    ("eta", value<double>()->default_value(0.1), "ハイパパラメータ(η)")
+    ("lambda", value<double>()->default_value(0.000001), "ハイパパラメータ(λ)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  const auto algorithm = vm["algorithm"].as<std::string>();
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto train = vm["train"].as<std::string>();
+  const auto test = vm["test"].as<std::string>();
+  const auto workers = vm["workers"].as<std::size_t>();
+  const auto interval = vm["interval"].as<std::size_t>();
+  const auto c = vm["c"].as<double>();
+  const auto eta = vm["eta"].as<double>();
+  const auto lambda = vm["lambda"].as<double>();
+
+  // without --rank the process forks the workers 1 .. workers - 1 and becomes worker 0
+  auto rank = vm["rank"].as<int>();
+  std::vector<pid_t> children;
+  if (rank < 0) {
+    rank = 0;
+    for (std::size_t r = 1; r < workers; ++r) {
+      const auto pid = ::fork();
+      if (pid == 0) {
+        rank = static_cast<int>(r);
+        children.clear();
+        break;
+      }
+      children.push_back(pid);
+    }
+  }
+
+  auto status = 0;
+  try {
+    parallel::UnixSocketTransport transport(vm["socket"].as<std::string>(), rank, workers);
+    if (algorithm == "adam") { run<ADAM>(transport, train, test, dim, interval, dim); }
+    else if (algorithm == "adagrad_rda") { run<ADAGRAD_RDA>(transport, train, test, dim, interval, dim, eta, lambda); }
+    else if (algorithm == "pa") { run<PA>(transport, train, test, dim, interval, dim, c); }
+    else {
+      std::cerr << "Unknown algorithm : " << algorithm << std::endl;
+      status = 1;
+    }
+  } catch (const std::runtime_error& e) {
+    std::cerr << "worker " << rank << " : " << e.what() << std::endl;
+    status = 1;
+  }
+
+  for (const auto pid : children) {
+    int child_status;
+    ::waitpid(pid, &child_status, 0);
+    if (!WIFEXITED(child_status) || WEXITSTATUS(child_status) != 0) { status = 1; }
+  }
+  return status;
+}
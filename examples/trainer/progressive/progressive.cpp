@@ -0,0 +1,66 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/multi_classifier.hpp>
+#include <mochimochi/trainer.hpp>
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+
+template <class Learner, typename... Args>
+void run(std::istream& is, const std::size_t dim, Args&&... args) {
+  trainer::OnlineTrainer<Learner> trainer(std::forward<Args>(args)...);
+  std::cout << "training..." << std::endl;
+  trainer.train(is, dim);
+  std::cout << trainer.metrics() << std::endl;
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("algorithm", value<std::string>()->default_value("arow"), "アルゴリズム")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("class", value<std::size_t>()->default_value(0), "クラス数 (多クラス分類)")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)")
+    ("c", value<double>()->default_value(1.0), "ハイパパラメータ(c)")
+    ("eta", value<double>()->default_value(0.95), "ハイパパラメータ(η)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) { std::cout << description << std::endl; }
+
+  const auto algorithm = vm["algorithm"].as<std::string>();
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto n_class = vm["class"].as<std::size_t>();
+  const auto r = vm["r"].as<double>();
+  const auto c = vm["c"].as<double>();
+  const auto eta = vm["eta"].as<double>();
+
+  std::ifstream train_data(vm["train"].as<std::string>());
+
+  if (algorithm == "arow") { run<AROW>(train_data, dim, dim, r); }
+  else if (algorithm == "scw") { run<SCW>(train_data, dim, dim, c, eta); }
+  else if (algorithm == "nherd") { run<NHERD>(train_data, dim, dim, c); }
+  else if (algorithm == "pa") { run<PA>(train_data, dim, dim, c); }
+  else if (algorithm == "adam") { run<ADAM>(train_data, dim, dim); }
+  else if (algorithm == "adagrad_rda") { run<ADAGRAD_RDA>(train_data, dim, dim, 0.1, 0.000001); }
+  else if (algorithm == "averaged_pa") { run<AVERAGED_PA>(train_data, dim, dim, c); }
+  else if (algorithm == "averaged_arow") { run<AVERAGED_AROW>(train_data, dim, dim, r); }
+  else if (algorithm == "marow") { run<MAROW>(train_data, dim, dim, n_class, r); }
+  else if (algorithm == "mscw") { run<MSCW>(train_data, dim, dim, n_class, c, eta); }
+  else if (algorithm == "mnherd") { run<MNHERD>(train_data, dim, dim, n_class, c); }
+  else if (algorithm == "mpa") { run<MPA>(train_data, dim, dim, n_class, c); }
+  else if (algorithm == "mcpa") { run<MCPA>(train_data, dim, dim, n_class, c); }
+  else if (algorithm == "mcarow") { run<MCAROW>(train_data, dim, dim, n_class, r); }
+  else if (algorithm == "mcscw") { run<MCSCW>(train_data, dim, dim, n_class, c, eta); }
+  else {
+    std::cerr << "Unknown algorithm : " << algorithm << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/parallel.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+// labels from a hidden linear model
+void generate(const std::size_t dim, const std::size_t examples, std::vector<Eigen::VectorXd>& features,
+              std::vector<int>& labels) {
+  std::mt19937 engine(1);
+  std::normal_distribution<double> normal(0.0, 1.0);
+  Eigen::VectorXd truth(dim);
+  for (std::size_t i = 0; i < dim; ++i) { truth[i] = normal(engine); }
+  for (std::size_t n = 0; n < examples; ++n) {
+    Eigen::VectorXd x(dim);
+    for (std::size_t i = 0; i < dim; ++i) { x[i] = normal(engine); }
+    labels.push_back(truth.dot(x) > 0.0 ? 1 : -1);
+    features.push_back(std::move(x));
+  }
+}
+
+// microseconds per example
+template <class Learner, class Update>
+double measure(Learner& learner, const std::vector<Eigen::VectorXd>& features, const std::vector<int>& labels,
+               Update update) {
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t n = 0; n < features.size(); ++n) { update(learner, features[n], labels[n]); }
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return 1e6 * seconds / features.size();
+}
+
+template <class Learner>
+void run(const Learner& initial, const std::size_t dim, const std::size_t threads,
+         const std::vector<Eigen::VectorXd>& features, const std::vector<int>& labels) {
+  auto serial = initial;
+  const auto base = measure(serial, features, labels, [](Learner& l, const Eigen::VectorXd& x, const int y) {
+                              l.update(x, y);
+                            });
+  std::cout << "serial : " << base << " us/example" << std::endl;
+
+  std::vector<std::size_t> counts;
+  for (std::size_t t = 1; t < threads; t *= 2) { counts.push_back(t); }
+  counts.push_back(threads);
+
+  for (const auto t : counts) {
+    parallel::ShardPool pool(dim, t);
+    auto sharded = initial;
+    const auto latency = measure(sharded, features, labels, [&](Learner& l, const Eigen::VectorXd& x, const int y) {
+                                   l.update(x, y, pool);
+                                 });
+    auto max_error = 0.0;
+    for (const auto& x : features) {
+      max_error = std::max(max_error, std::abs(sharded.compute_margin(x, pool) - serial.compute_margin(x)));
+    }
+    std::cout << "threads=" << t << " : " << latency << " us/example, speedup=" << base / latency
+              << ", max margin difference=" << max_error << std::endl;
+  }
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("algorithm", value<std::string>()->default_value("arow"), "学習アルゴリズム (arow, scw)")
+    ("dim", value<std::size_t>()->default_value(1 << 22), "データの次元数")
+    ("examples", value<std::size_t>()->default_value(200), "事例数")
+    ("threads", value<std::size_t>()->default_value(std::max(1u, std::thread::hardware_concurrency())), "最大スレッド数")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)")
+    ("c", value<double>()->default_value(1.0), "ハイパパラメータ(c)")
+    ("eta", value<double>()->default_value(0.9), "ハイパパラメータ(eta)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  const auto algorithm = vm["algorithm"].as<std::string>();
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto threads = std::max<std::size_t>(1, vm["threads"].as<std::size_t>());
+
+  std::vector<Eigen::VectorXd> features;
+  std::vector<int> labels;
+  generate(dim, vm["examples"].as<std::size_t>(), features, labels);
+
+  if (algorithm == "arow") {
+    run(AROW(dim, vm["r"].as<double>()), dim, threads, features, labels);
+  } else if (algorithm == "scw") {
+    run(SCW(dim, vm["c"].as<double>(), vm["eta"].as<double>()), dim, threads, features, labels);
+  } else {
+    std::cerr << "Unknown algorithm : " << algorithm << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/multi_classifier.hpp>
+#include <mochimochi/trainer.hpp>
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+template <typename T>
+std::vector<T> split(const std::string& values) {
+  std::vector<T> result;
+  std::istringstream iss(values);
+  std::string token;
+  while (std::getline(iss, token, ',')) {
+    if (token.empty()) { continue; }
+    std::istringstream value(token);
+    T v;
+    value >> v;
+    result.push_back(v);
+  }
+  return result;
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("algorithm", value<std::string>()->default_value("arow"), "アルゴリズム (カンマ区切り)")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("class", value<std::size_t>()->default_value(0), "クラス数 (多クラス分類)")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("r", value<std::string>()->default_value("0.5"), "ハイパパラメータ(r) (カンマ区切り)")
+    ("c", value<std::string>()->default_value("1.0"), "ハイパパラメータ(c) (カンマ区切り)")
+    ("eta", value<std::string>()->default_value("0.95"), "ハイパパラメータ(η) (カンマ区切り)")
+    ("threads", value<std::size_t>()->default_value(std::max(1u, std::thread::hardware_concurrency())), "スレッド数")
+    ("batch", value<std::size_t>()->default_value(1024), "スレッド間で同期する事例数");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) { std::cout << description << std::endl; }
+
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto n_class = vm["class"].as<std::size_t>();
+  const auto rs = split<double>(vm["r"].as<std::string>());
+  const auto cs = split<double>(vm["c"].as<std::string>());
+  const auto etas = split<double>(vm["eta"].as<std::string>());
+
+  const std::set<std::string> known { "arow", "averaged_arow", "marow", "mcarow", "nherd", "pa", "averaged_pa",
+                                      "mnherd", "mpa", "mcpa", "scw", "mscw", "mcscw" };
+  const auto algorithms = split<std::string>(vm["algorithm"].as<std::string>());
+  for (const auto& algorithm : algorithms) {
+    if (known.count(algorithm) == 0) {
+      std::cerr << "Unknown algorithm : " << algorithm << std::endl;
+      return 1;
+    }
+  }
+
+  trainer::SweepTrainer sweep(vm["threads"].as<std::size_t>(), vm["batch"].as<std::size_t>());
+  for (const auto& algorithm : algorithms) {
+    for (const auto r : rs) {
+      const auto name = algorithm + " r=" + std::to_string(r);
+      if (algorithm == "arow") { sweep.add<AROW>(name, dim, r); }
+      else if (algorithm == "averaged_arow") { sweep.add<AVERAGED_AROW>(name, dim, r); }
+      else if (algorithm == "marow") { sweep.add<MAROW>(name, dim, n_class, r); }
+      else if (algorithm == "mcarow") { sweep.add<MCAROW>(name, dim, n_class, r); }
+    }
+    for (const auto c : cs) {
+      const auto name = algorithm + " c=" + std::to_string(c);
+      if (algorithm == "nherd") { sweep.add<NHERD>(name, dim, c); }
+      else if (algorithm == "pa") { sweep.add<PA>(name, dim, c); }
+      else if (algorithm == "averaged_pa") { sweep.add<AVERAGED_PA>(name, dim, c); }
+      else if (algorithm == "mnherd") { sweep.add<MNHERD>(name, dim, n_class, c); }
+      else if (algorithm == "mpa") { sweep.add<MPA>(name, dim, n_class, c); }
+      else if (algorithm == "mcpa") { sweep.add<MCPA>(name, dim, n_class, c); }
+      for (const auto eta : etas) {
+        const auto scw_name = name + " eta=" + std::to_string(eta);
+        if (algorithm == "scw") { sweep.add<SCW>(scw_name, dim, c, eta); }
+        else if (algorithm == "mscw") { sweep.add<MSCW>(scw_name, dim, n_class, c, eta); }
+        else if (algorithm == "mcscw") { sweep.add<MCSCW>(scw_name, dim, n_class, c, eta); }
+      }
+    }
+  }
+
+  std::ifstream train_data(vm["train"].as<std::string>());
+  std::cout << "training " << sweep.size() << " models..." << std::endl;
+  sweep.train(train_data, dim);
+
+  for (std::size_t i = 0; i < sweep.size(); ++i) {
+    std::cout << sweep.name(i) << " : " << sweep.metrics(i) << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include <mochimochi/binary_classifier.hpp>
+#include <mochimochi/utility.hpp>
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+
+using Examples = std::vector<std::pair<int, Eigen::VectorXd>>;
+
+Examples read(const std::string& path, const std::size_t dim) {
+  Examples examples;
+  std::ifstream ifs(path);
+  std::string line;
+  while (std::getline(ifs, line)) {
+    if (line.empty()) { continue; }
+    examples.push_back(utility::read_ones<int>(line, dim));
+  }
+  return examples;
+}
+
+template <class Learner>
+void learn(Learner& learner, Examples::const_iterator first, Examples::const_iterator last) {
+  for (; first != last; ++first) { learner.update(first->second, first->first); }
+}
+
+template <class Learner>
+double accuracy(const Learner& learner, const Examples& test) {
+  std::size_t correct = 0;
+  for (const auto& example : test) {
+    if (learner.predict(example.second) == example.first) { ++correct; }
+  }
+  return static_cast<double>(correct) / test.size();
+}
+
+// yesterday : the first half of the training data, today : the second half
+template <class Learner, typename... Args>
+void run(const Examples& train, const Examples& test, const std::string& model, Args&&... args) {
+  const auto middle = train.begin() + train.size() / 2;
+
+  Learner yesterday(args...);
+  learn(yesterday, train.begin(), middle);
+  yesterday.save(model);
+
+  Learner warm(args...);
+  warm.warm_start(model);
+  learn(warm, middle, train.end());
+
+  Learner today(args...);
+  learn(today, middle, train.end());
+  Learner merged(yesterday);
+  merged.merge(today);
+
+  Learner scratch(args...);
+  learn(scratch, train.begin(), train.end());
+
+  std::cout << "yesterday only    : " << accuracy(yesterday, test) << std::endl;
+  std::cout << "today only        : " << accuracy(today, test) << std::endl;
+  std::cout << "warm start        : " << accuracy(warm, test) << std::endl;
+  std::cout << "merged            : " << accuracy(merged, test) << std::endl;
+  std::cout << "retrained (all)   : " << accuracy(scratch, test) << std::endl;
+}
+
+int main(const int ac, const char* const * const av) {
+  using namespace boost::program_options;
+
+  options_description description("options");
+  description.add_options()
+    ("help", "")
+    ("algorithm", value<std::string>()->default_value("arow"), "アルゴリズム")
+    ("dim", value<std::size_t>()->default_value(0), "データの次元数")
+    ("train", value<std::string>()->default_value(""), "学習データのファイルパス")
+    ("test", value<std::string>()->default_value(""), "テストデータのファイルパス")
+    ("model", value<std::string>()->default_value("yesterday.model"), "前半で学習したモデルの保存先")
+    ("r", value<double>()->default_value(0.5), "ハイパパラメータ(r)")
+    ("c", value<double>()->default_value(1.0), "ハイパパラメータ(c)")
+    ("eta", value<double>()->default_value(0.95), "ハイパパラメータ(η)");
+
+  variables_map vm;
+  store(parse_command_line(ac, av, description), vm);
+  notify(vm);
+
+  if(vm.count("help")) {
+    std::cout << description << std::endl;
+    return 0;
+  }
+
+  const auto algorithm = vm["algorithm"].as<std::string>();
+  const auto dim = vm["dim"].as<std::size_t>();
+  const auto model = vm["model"].as<std::string>();
+  const auto r = vm["r"].as<double>();
+  const auto c = vm["c"].as<double>();
+  const auto eta = vm["eta"].as<double>();
+  const auto train = read(vm["train"].as<std::string>(), dim);
+  const auto test = read(vm["test"].as<std::string>(), dim);
+
+  try {
+    if (algorithm == "arow") { run<AROW>(train, test, model, dim, r); }
+    else if (algorithm == "scw") { run<SCW>(train, test, model, dim, c, eta); }
+    else if (algorithm == "nherd") { run<NHERD>(train, test, model, dim, c); }
+    else if (algorithm == "pa") { run<PA>(train, test, model, dim, c); }
+    else if (algorithm == "averaged_pa") { run<AVERAGED_PA>(train, test, model, dim, c); }
+    else if (algorithm == "averaged_arow") { run<AVERAGED_AROW>(train, test, model, dim, r); }
+    else if (algorithm == "adam") { run<ADAM>(train, test, model, dim); }
+    else if (algorithm == "adagrad_rda") { run<ADAGRAD_RDA>(train, test, model, dim, 0.1, 0.000001); }
+    else {
+      std::cerr << "Unknown algorithm : " << algorithm << std::endl;
+      return 1;
+    }
+  } catch (const std::runtime_error& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -7,5 +7,7 @@
 #include "./classifier/binary/pa.hpp"
 #include "./classifier/binary/adam.hpp"
 #include "./classifier/binary/adagrad_rda.hpp"
+#include "./classifier/binary/averaged_pa.hpp"
+#include "./classifier/binary/averaged_arow.hpp"
 
 #endif //MOCHIMOCHI_BINARY_CLASSIFIER_HPP_
@@ -2,7 +2,16 @@
 #define MOCHIMOCHI_ADAGRAD_RDA_HPP_
 
 #include <Eigen/Dense>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <cassert>
+#include <fstream>
 #include "../../functions/enumerate.hpp"
+#include "../../functions/merge.hpp"
 
 class ADAGRAD_RDA {
 private :
@@ -11,10 +20,14 @@ private :
   const double kLambda;
 
 private :
-  std::size_t _timestep;
+  double _timestep;
   Eigen::VectorXd _w;
   Eigen::VectorXd _h;
   Eigen::VectorXd _g;
+  // state agreed on by the workers at the last synchronize (data parallel training only)
+  double _synced_timestep;
+  Eigen::VectorXd _synced_h;
+  Eigen::VectorXd _synced_g;
 
 public :
   ADAGRAD_RDA(const std::size_t dim, const double eta, const double lambda)
@@ -24,7 +37,8 @@ public :
       _timestep(0),
       _w(Eigen::VectorXd::Zero(kDim)),
       _h(Eigen::VectorXd::Zero(kDim)),
-      _g(Eigen::VectorXd::Zero(kDim)) {
+      _g(Eigen::VectorXd::Zero(kDim)),
+      _synced_timestep(0) {
     static_assert(std::numeric_limits<decltype(dim)>::max() > 0, "Dimension Error. (Dimension > 0)");
     static_assert(std::numeric_limits<decltype(eta)>::max() > 0, "Hyper Parameter Error. (eta > 0)");
     static_assert(std::numeric_limits<decltype(lambda)>::max() > 0, "Hyper Parameter Error. (lambda > 0)");
@@ -37,37 +51,168 @@ public :
 
 private :
 
-  double calculate_margin(const Eigen::VectorXd& x) const {
-    return _w.dot(x);
-  }
-
   double suffer_loss(const Eigen::VectorXd& x, const int y) const {
     return std::max(0.0, 1.0 - y * _w.dot(x));
   }
 
+  double compute_weight(const std::size_t index) const {
+    const auto sign = _g[index] >= 0 ? 1 : -1;
+    const auto eta = kEta / std::sqrt(_h[index]);
+    const auto u = std::abs(_g[index]) / _timestep;
+    return (u <= kLambda) ? 0.0 : -sign * eta * _timestep * (u - kLambda);
+  }
+
+  void refresh_weight(void) {
+    for (std::size_t i = 0; i < kDim; ++i) {
+      _w[i] = (_h[i] > 0.0) ? compute_weight(i) : 0.0;
+    }
+  }
+
 public :
 
   bool update(const Eigen::VectorXd& feature, const int label) {
+    return update(feature, label, 1.0);
+  }
+
+  // importance weight : the gradient sums and the timestep grow as if
+  // the example had been seen `weight` times in a row
+  bool update(const Eigen::VectorXd& feature, const int label, const double weight) {
     if (suffer_loss(feature, label) <= 0.0) { return false; }
 
-    _timestep++;
+    _timestep += weight;
     functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
                        [&](const int index, const double value) {
                          const auto gradiant = -label * value;
-                         _g[index] += gradiant;
-                         _h[index] += gradiant * gradiant;
-
-                         const auto sign = _g[index] >= 0 ? 1 : -1;
-                         const auto eta = kEta / std::sqrt(_h[index]);
-                         const auto u = std::abs(_g[index]) / _timestep;
-
-                         _w[index] = (u <= kLambda) ? 0.0 : -sign * eta * _timestep * (u - kLambda);
+                         _g[index] += weight * gradiant;
+                         _h[index] += weight * gradiant * gradiant;
+                         _w[index] = compute_weight(index);
                        });
     return true;
   }
 
+  double compute_margin(const Eigen::VectorXd& x) const {
+    return _w.dot(x);
+  }
+
+  // weights an update can move, in or out of the example (inference::Tracked) :
+  // every feature with a gradient, as the timestep grows
+  bool moved(const std::size_t index) const {
+    return _h[index] > 0.0;
+  }
+
   int predict(const Eigen::VectorXd& x) const {
-    return calculate_margin(x) > 0.0 ? 1 : -1;
+    return compute_margin(x) > 0.0 ? 1 : -1;
+  }
+
+  Eigen::VectorXd get_weight(void) const {
+    return _w;
+  }
+
+  // data parallel training (parallel::Allreduce) : the workers add up the
+  // gradients (and squared gradients) accumulated since the last synchronize,
+  // which is the dual average of a single learner seeing all the shards
+  template <class Reducer>
+  void synchronize(Reducer& reducer) {
+    if (_synced_g.size() == 0) {
+      _synced_h = Eigen::VectorXd::Zero(kDim);
+      _synced_g = Eigen::VectorXd::Zero(kDim);
+    }
+
+    _h -= _synced_h;
+    _g -= _synced_g;
+    double steps = _timestep - _synced_timestep;
+    reducer.sum(_h);
+    reducer.sum(_g);
+    reducer.sum(&steps, 1);
+    _h += _synced_h;
+    _g += _synced_g;
+    _timestep = _synced_timestep + steps;
+
+    _synced_h = _h;
+    _synced_g = _g;
+    _synced_timestep = _timestep;
+    refresh_weight();
+  }
+
+  // continues the training of a model saved with the same dimension and hyper parameters
+  void warm_start(const std::string& filename) {
+    functions::check_readable(filename);
+    ADAGRAD_RDA saved(*this);
+    saved.load(filename);
+    functions::check_compatible("dimension", kDim, saved.kDim);
+    functions::check_compatible("eta", kEta, saved.kEta);
+    functions::check_compatible("lambda", kLambda, saved.kLambda);
+    _timestep = saved._timestep;
+    _w = saved._w;
+    _h = saved._h;
+    _g = saved._g;
+    _synced_timestep = saved._synced_timestep;
+    _synced_h = saved._synced_h;
+    _synced_g = saved._synced_g;
+  }
+
+  // adds the (weighted) gradient sums of a model trained on other data,
+  // as if this model had also seen that data
+  void merge(const ADAGRAD_RDA& other, const double weight = 1.0) {
+    functions::check_compatible("dimension", kDim, other.kDim);
+    _h += weight * other._h;
+    _g += weight * other._g;
+    _timestep += weight * other._timestep;
+    refresh_weight();
+  }
+
+  void save(const std::string& filename) {
+    std::ofstream ofs(filename);
+    assert(ofs);
+    boost::archive::text_oarchive oa(ofs);
+    oa << *this;
+    ofs.close();
+  }
+
+  void load(const std::string& filename) {
+    std::ifstream ifs(filename);
+    assert(ifs);
+    boost::archive::text_iarchive ia(ifs);
+    ia >> *this;
+    ifs.close();
+  }
+
+private :
+  friend class boost::serialization::access;
+  BOOST_SERIALIZATION_SPLIT_MEMBER();
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const {
+    std::vector<double> w(_w.data(), _w.data() + _w.size());
+    std::vector<double> h(_h.data(), _h.data() + _h.size());
+    std::vector<double> g(_g.data(), _g.data() + _g.size());
+    ar & boost::serialization::make_nvp("weight", w);
+    ar & boost::serialization::make_nvp("h", h);
+    ar & boost::serialization::make_nvp("g", g);
+    ar & boost::serialization::make_nvp("timestep", const_cast<double&>(_timestep));
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("eta", const_cast<double&>(kEta));
+    ar & boost::serialization::make_nvp("lambda", const_cast<double&>(kLambda));
+  }
+
+  // a loaded model is the common starting point of data parallel workers
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version) {
+    std::vector<double> w;
+    std::vector<double> h;
+    std::vector<double> g;
+    ar & boost::serialization::make_nvp("weight", w);
+    ar & boost::serialization::make_nvp("h", h);
+    ar & boost::serialization::make_nvp("g", g);
+    ar & boost::serialization::make_nvp("timestep", _timestep);
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("eta", const_cast<double&>(kEta));
+    ar & boost::serialization::make_nvp("lambda", const_cast<double&>(kLambda));
+    _w = Eigen::Map<Eigen::VectorXd>(&w[0], w.size());
+    _h = Eigen::Map<Eigen::VectorXd>(&h[0], h.size());
+    _g = Eigen::Map<Eigen::VectorXd>(&g[0], g.size());
+    _synced_timestep = _timestep;
+    _synced_h = _h;
+    _synced_g = _g;
   }
 
 };
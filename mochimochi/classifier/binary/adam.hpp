@@ -2,8 +2,16 @@
 #define MOCHIMOCHI_ADAM_HPP_
 
 #include <Eigen/Dense>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
 #include <cassert>
+#include <fstream>
 #include "../../functions/enumerate.hpp"
+#include "../../functions/merge.hpp"
 
 class ADAM {
 private :
@@ -34,13 +42,15 @@ private :
     return std::max(0.0, 1.0 - y * _w.dot(x));
   }
 
-  double calculate_margin(const Eigen::VectorXd& x) const {
-    return _w.dot(x);
-  }
-
 public :
 
   bool update(const Eigen::VectorXd& feature, const int label) {
+    return update(feature, label, 1.0);
+  }
+
+  // importance weight : the moments see the gradient once and the step is scaled by
+  // `weight`, close to `weight` consecutive steps while the moments change slowly
+  bool update(const Eigen::VectorXd& feature, const int label, const double weight) {
     constexpr auto kAlpha = 0.001;
     constexpr auto kBeta1 = 0.9;
     constexpr auto kBeta2 = 0.999;
@@ -49,24 +59,115 @@ public :
 
     if (suffer_loss(feature, label) <= 0.0) { return false; }
 
-    const Eigen::VectorXd gradiant = -label * feature;
     const auto beta1_t = std::pow(kLambda, _timestep) * kBeta1;
 
     _timestep++;
-    functions::enumerate(gradiant.data(), gradiant.data() + gradiant.size(), 0,
-                       [&](const std::size_t index, const double value) {
+    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
+                       [&](const std::size_t index, const double x) {
+                         const auto value = -label * x;
                          _m[index] = beta1_t * _m[index] + (1.0 - beta1_t) * value;
                          _v[index] = kBeta2 * _v[index] + (1.0 - kBeta2) * value * value;
                          const auto m_t = _m[index] / (1.0 - std::pow(kBeta1, _timestep));
                          const auto v_t = _v[index] / (1.0 - std::pow(kBeta2, _timestep));
-                         _w[index] -= kAlpha * m_t / (std::sqrt(v_t) + kEpsilon);
+                         _w[index] -= weight * kAlpha * m_t / (std::sqrt(v_t) + kEpsilon);
                        });
 
     return true;
   }
 
+  double compute_margin(const Eigen::VectorXd& x) const {
+    return _w.dot(x);
+  }
+
+  // weights an update can move, in or out of the example (inference::Tracked) :
+  // every feature with momentum
+  bool moved(const std::size_t index) const {
+    return _m[index] != 0.0;
+  }
+
   int predict(const Eigen::VectorXd& feature) const {
-    return calculate_margin(feature) > 0.0 ? 1 : -1;
+    return compute_margin(feature) > 0.0 ? 1 : -1;
+  }
+
+  Eigen::VectorXd get_weight(void) const {
+    return _w;
+  }
+
+  // data parallel training (parallel::Allreduce) : the workers average the
+  // weights and both moments, the bias corrections keep their local timestep
+  template <class Reducer>
+  void synchronize(Reducer& reducer) {
+    reducer.average(_w);
+    reducer.average(_m);
+    reducer.average(_v);
+  }
+
+  // continues the training of a model saved with the same dimension
+  void warm_start(const std::string& filename) {
+    functions::check_readable(filename);
+    ADAM saved(*this);
+    saved.load(filename);
+    functions::check_compatible("dimension", kDim, saved.kDim);
+    _timestep = saved._timestep;
+    _w = saved._w;
+    _m = saved._m;
+    _v = saved._v;
+  }
+
+  // weighted average with a model trained on other data : (1 - weight) * this + weight * other,
+  // for the weights and both moments (the timestep is the larger one)
+  void merge(const ADAM& other, const double weight = 0.5) {
+    functions::check_compatible("dimension", kDim, other.kDim);
+    functions::merge_average(_w, other._w, weight);
+    functions::merge_average(_m, other._m, weight);
+    functions::merge_average(_v, other._v, weight);
+    _timestep = std::max(_timestep, other._timestep);
+  }
+
+  void save(const std::string& filename) {
+    std::ofstream ofs(filename);
+    assert(ofs);
+    boost::archive::text_oarchive oa(ofs);
+    oa << *this;
+    ofs.close();
+  }
+
+  void load(const std::string& filename) {
+    std::ifstream ifs(filename);
+    assert(ifs);
+    boost::archive::text_iarchive ia(ifs);
+    ia >> *this;
+    ifs.close();
+  }
+
+private :
+  friend class boost::serialization::access;
+  BOOST_SERIALIZATION_SPLIT_MEMBER();
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const {
+    std::vector<double> w(_w.data(), _w.data() + _w.size());
+    std::vector<double> m(_m.data(), _m.data() + _m.size());
+    std::vector<double> v(_v.data(), _v.data() + _v.size());
+    ar & boost::serialization::make_nvp("weight", w);
+    ar & boost::serialization::make_nvp("m", m);
+    ar & boost::serialization::make_nvp("v", v);
+    ar & boost::serialization::make_nvp("timestep", const_cast<std::size_t&>(_timestep));
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+  }
+
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version) {
+    std::vector<double> w;
+    std::vector<double> m;
+    std::vector<double> v;
+    ar & boost::serialization::make_nvp("weight", w);
+    ar & boost::serialization::make_nvp("m", m);
+    ar & boost::serialization::make_nvp("v", v);
+    ar & boost::serialization::make_nvp("timestep", _timestep);
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    _w = Eigen::Map<Eigen::VectorXd>(&w[0], w.size());
+    _m = Eigen::Map<Eigen::VectorXd>(&m[0], m.size());
+    _v = Eigen::Map<Eigen::VectorXd>(&v[0], v.size());
   }
 
 };
@@ -10,6 +10,9 @@
 #include <boost/archive/text_iarchive.hpp>
 #include <fstream>
 #include "../../functions/enumerate.hpp"
+#include "../../functions/merge.hpp"
+#include "../../kernel/dispatch.hpp"
+#include "../../parallel/shard_pool.hpp"
 
 class AROW {
 private :
@@ -42,39 +45,59 @@ private :
     return margin * label;
   }
 
-  double compute_margin(const Eigen::VectorXd& x) const {
-    return _means.dot(x);
+public :
+
+  bool update(const Eigen::VectorXd& feature, const int label) {
+    return update(feature, label, 1.0);
   }
 
-  double compute_confidence(const Eigen::VectorXd& feature) const {
-    auto confidence = 0.0;
-    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
-                         [&](const int index, const double value) {
-                           confidence += _covariances[index] * value * value;
-                         });
-    return confidence;
+  // importance weight : the loss of the example counts `weight` times (r / weight)
+  bool update(const Eigen::VectorXd& feature, const int label, const double weight) {
+    const auto margin = compute_margin(feature);
+
+    if (suffer_loss(margin, label) >= 1.0) { return false; }
+
+    return update(feature, label, margin, compute_confidence(feature), weight);
   }
 
-public :
+  // margin and confidence already computed for this feature (selective sampling)
+  bool update(const Eigen::VectorXd& feature, const int label, const double margin, const double confidence,
+              const double weight = 1.0) {
+    if (suffer_loss(margin, label) >= 1.0) { return false; }
 
-  bool update(const Eigen::VectorXd& feature, const int label) {
-    const auto margin = compute_margin(feature);
+    const auto beta = 1.0 / (confidence + kR / weight);
+    const auto alpha = std::max(0.0, 1.0 - label * margin) * beta;
 
+    kernel::update(_means, _covariances, feature, alpha * label, beta);
+    return true;
+  }
+
+  // feature sharded : the margin and the confidence are summed over the shards
+  // of the pool in one pass, then every shard updates its own range
+  bool update(const Eigen::VectorXd& feature, const int label, parallel::ShardPool& pool, const double weight = 1.0) {
+    const auto scored = parallel::sharded_margin_confidence(pool, _means, _covariances, feature);
+    const auto margin = scored.first;
     if (suffer_loss(margin, label) >= 1.0) { return false; }
 
-    const auto confidence = compute_confidence(feature);
-    const auto beta = 1.0 / (confidence + kR);
+    const auto beta = 1.0 / (scored.second + kR / weight);
     const auto alpha = std::max(0.0, 1.0 - label * margin) * beta;
 
-    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
-                         [&](const int index, const double value) {
-                           const auto v = _covariances[index] * value;
-                           _means[index] += alpha * label * v;
-                           _covariances[index] -= beta * v * v;
-                         });
+    parallel::sharded_update(pool, _means, _covariances, feature, alpha * label, beta);
     return true;
   }
 
+  double compute_margin(const Eigen::VectorXd& x) const {
+    return kernel::dot(_means, x);
+  }
+
+  double compute_margin(const Eigen::VectorXd& x, parallel::ShardPool& pool) const {
+    return parallel::sharded_dot(pool, _means, x);
+  }
+
+  double compute_confidence(const Eigen::VectorXd& feature) const {
+    return kernel::confidence(_covariances, feature);
+  }
+
   int predict(const Eigen::VectorXd& x) const {
     return compute_margin(x) > 0.0 ? 1 : -1;
   }
@@ -83,6 +106,24 @@ public :
     return _means;
   }
 
+  // continues the training of a model saved with the same dimension and hyper parameters
+  void warm_start(const std::string& filename) {
+    functions::check_readable(filename);
+    AROW saved(*this);
+    saved.load(filename);
+    functions::check_compatible("dimension", kDim, saved.kDim);
+    functions::check_compatible("r", kR, saved.kR);
+    _covariances = saved._covariances;
+    _means = saved._means;
+  }
+
+  // precision weighted merge with a model trained on other data,
+  // weight scales the evidence taken from `other` (1 : as much as from this model)
+  void merge(const AROW& other, const double weight = 1.0) {
+    functions::check_compatible("dimension", kDim, other.kDim);
+    functions::merge_gaussians(_means, _covariances, other._means, other._covariances, weight);
+  }
+
   void save(const std::string& filename) {
     std::ofstream ofs(filename);
     assert(ofs);
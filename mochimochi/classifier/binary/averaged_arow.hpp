@@ -0,0 +1,179 @@
+#ifndef MOCHIMOCHI_AVERAGED_AROW_HPP_
+#define MOCHIMOCHI_AVERAGED_AROW_HPP_
+
+#include <Eigen/Dense>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <fstream>
+#include "../../functions/enumerate.hpp"
+#include "../../functions/merge.hpp"
+#include "../../kernel/dispatch.hpp"
+
+// AROW predicting with the average of the means over all examples seen.
+// The average is kept lazily : _accumulated holds sum((t - 1) * delta_t),
+// so that average = means - accumulated / timestep and each update only
+// touches the non-zero features of the example.
+class AVERAGED_AROW {
+private :
+  const std::size_t kDim;
+  const double kR;
+
+private :
+  double _timestep;
+  Eigen::VectorXd _covariances;
+  Eigen::VectorXd _means;
+  Eigen::VectorXd _accumulated;
+
+public :
+  AVERAGED_AROW(const std::size_t dim, const double r)
+    : kDim(dim),
+      kR(r),
+      _timestep(0),
+      _covariances(Eigen::VectorXd::Ones(kDim)),
+      _means(Eigen::VectorXd::Zero(kDim)),
+      _accumulated(Eigen::VectorXd::Zero(kDim)) {
+
+    static_assert(std::numeric_limits<decltype(dim)>::max() > 0, "Dimension Error. (Dimension > 0)");
+    static_assert(std::numeric_limits<decltype(r)>::max() > 0, "Hyper Parameter Error. (r > 0)");
+    assert(dim > 0);
+    assert(r > 0);
+
+  }
+
+  virtual ~AVERAGED_AROW() { }
+
+private :
+
+  double suffer_loss(const double margin, const int label) const {
+    return margin * label;
+  }
+
+  double compute_confidence(const Eigen::VectorXd& feature) const {
+    return kernel::confidence(_covariances, feature);
+  }
+
+public :
+
+  bool update(const Eigen::VectorXd& feature, const int label) {
+    return update(feature, label, 1.0);
+  }
+
+  // importance weight : the example counts `weight` times, in the loss (r / weight)
+  // and in the average (it lasts `weight` timesteps)
+  bool update(const Eigen::VectorXd& feature, const int label, const double weight) {
+    const auto margin = _means.dot(feature);
+    const auto timestep = _timestep;
+    _timestep += weight;
+
+    if (suffer_loss(margin, label) >= 1.0) { return false; }
+
+    const auto confidence = compute_confidence(feature);
+    const auto beta = 1.0 / (confidence + kR / weight);
+    const auto alpha = std::max(0.0, 1.0 - label * margin) * beta;
+
+    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
+                         [&](const int index, const double value) {
+                           if (value == 0.0) { return; }
+                           const auto v = _covariances[index] * value;
+                           const auto delta = alpha * label * v;
+                           _means[index] += delta;
+                           _accumulated[index] += timestep * delta;
+                           _covariances[index] -= beta * v * v;
+                         });
+    return true;
+  }
+
+  // margin of the averaged model
+  double compute_margin(const Eigen::VectorXd& x) const {
+    if (_timestep == 0) { return _means.dot(x); }
+    return _means.dot(x) - _accumulated.dot(x) / _timestep;
+  }
+
+  int predict(const Eigen::VectorXd& x) const {
+    return compute_margin(x) > 0.0 ? 1 : -1;
+  }
+
+  Eigen::VectorXd get_means(void) const {
+    if (_timestep == 0) { return _means; }
+    return _means - _accumulated / _timestep;
+  }
+
+  // continues the training of a model saved with the same dimension and hyper parameters
+  void warm_start(const std::string& filename) {
+    functions::check_readable(filename);
+    AVERAGED_AROW saved(*this);
+    saved.load(filename);
+    functions::check_compatible("dimension", kDim, saved.kDim);
+    functions::check_compatible("r", kR, saved.kR);
+    _timestep = saved._timestep;
+    _covariances = saved._covariances;
+    _means = saved._means;
+    _accumulated = saved._accumulated;
+  }
+
+  // precision weighted merge with a model trained on other data (see AROW::merge), applied to the means
+  // and to their averages ; the examples of `other` count `weight` times in the average that goes on
+  void merge(const AVERAGED_AROW& other, const double weight = 1.0) {
+    functions::check_compatible("dimension", kDim, other.kDim);
+    Eigen::VectorXd average = get_means();
+    Eigen::VectorXd covariances = _covariances;
+    functions::merge_gaussians(average, covariances, other.get_means(), other._covariances, weight);
+    functions::merge_gaussians(_means, _covariances, other._means, other._covariances, weight);
+    _timestep += weight * other._timestep;
+    _accumulated = _timestep * (_means - average);
+  }
+
+  void save(const std::string& filename) {
+    std::ofstream ofs(filename);
+    assert(ofs);
+    boost::archive::text_oarchive oa(ofs);
+    oa << *this;
+    ofs.close();
+  }
+
+  void load(const std::string& filename) {
+    std::ifstream ifs(filename);
+    assert(ifs);
+    boost::archive::text_iarchive ia(ifs);
+    ia >> *this;
+    ifs.close();
+  }
+
+private :
+  friend class boost::serialization::access;
+  BOOST_SERIALIZATION_SPLIT_MEMBER();
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const {
+    std::vector<double> covariances_vector(_covariances.data(), _covariances.data() + _covariances.size());
+    std::vector<double> means_vector(_means.data(), _means.data() + _means.size());
+    std::vector<double> accumulated_vector(_accumulated.data(), _accumulated.data() + _accumulated.size());
+    ar & boost::serialization::make_nvp("covariances", covariances_vector);
+    ar & boost::serialization::make_nvp("means", means_vector);
+    ar & boost::serialization::make_nvp("accumulated", accumulated_vector);
+    ar & boost::serialization::make_nvp("timestep", const_cast<double&>(_timestep));
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("r", const_cast<double&>(kR));
+  }
+
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version) {
+    std::vector<double> covariances_vector;
+    std::vector<double> means_vector;
+    std::vector<double> accumulated_vector;
+    ar & boost::serialization::make_nvp("covariances", covariances_vector);
+    ar & boost::serialization::make_nvp("means", means_vector);
+    ar & boost::serialization::make_nvp("accumulated", accumulated_vector);
+    ar & boost::serialization::make_nvp("timestep", _timestep);
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("r", const_cast<double&>(kR));
+    _covariances = Eigen::Map<Eigen::VectorXd>(&covariances_vector[0], covariances_vector.size());
+    _means = Eigen::Map<Eigen::VectorXd>(&means_vector[0], means_vector.size());
+    _accumulated = Eigen::Map<Eigen::VectorXd>(&accumulated_vector[0], accumulated_vector.size());
+  }
+};
+
+#endif //MOCHIMOCHI_AVERAGED_AROW_HPP_
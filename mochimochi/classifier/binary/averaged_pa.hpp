@@ -0,0 +1,188 @@
+#ifndef MOCHIMOCHI_AVERAGED_PA_HPP_
+#define MOCHIMOCHI_AVERAGED_PA_HPP_
+
+#include <Eigen/Dense>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <fstream>
+#include <functional>
+#include "../../functions/enumerate.hpp"
+#include "../../functions/merge.hpp"
+
+// PA predicting with the average of the weights over all examples seen.
+// The average is kept lazily : _accumulated holds sum((t - 1) * delta_t),
+// so that average = weight - accumulated / timestep and each update only
+// touches the non-zero features of the example.
+class AVERAGED_PA {
+private :
+  const std::size_t kDim;
+  const double kC;
+  const int kSelect;
+
+private :
+  double _timestep;
+  Eigen::VectorXd _weight;
+  Eigen::VectorXd _accumulated;
+  std::function<double(double, double, double)> _compute_tau;
+
+public :
+  AVERAGED_PA(const std::size_t dim, const double C, const int select = 2)
+    : kDim(dim),
+      kC(C),
+      kSelect(select),
+      _timestep(0),
+      _weight(Eigen::VectorXd::Zero(dim)),
+      _accumulated(Eigen::VectorXd::Zero(dim)) {
+
+    static_assert(std::numeric_limits<decltype(dim)>::max() > 0, "Dimension Error. (Dimension > 0)");
+    static_assert(std::numeric_limits<decltype(C)>::max() > 0, "Hyper Parameter Error. (C > 0)");
+
+    // int select : switching the PA algorithm
+    // 0 : PA
+    // 1 : PA-1
+    // 2 : PA-2
+    switch(kSelect) {
+    case 0 :
+      _compute_tau = [](const auto norm, const auto loss, const auto) {
+        return loss / norm;
+      };
+      break;
+    case 1 :
+      _compute_tau = [](const auto norm, const auto loss, const auto c) {
+        return std::min(c, loss / norm);
+      };
+      break;
+    case 2 :
+      _compute_tau = [](const auto norm, const auto loss, const auto c) {
+        return loss / (norm + 1.0 / (2.0 * c));
+      };
+      break;
+    default:
+      throw std::runtime_error("Error in the PA algorithm.");
+    }
+
+  }
+
+  virtual ~AVERAGED_PA() { }
+
+private :
+
+  double suffer_loss(const Eigen::VectorXd& x, const int y) const {
+    return std::max(0.0, 1.0 - y * _weight.dot(x));
+  }
+
+public :
+
+  bool update(const Eigen::VectorXd& feature, const int label) {
+    return update(feature, label, 1.0);
+  }
+
+  // importance weight : the example counts `weight` times, in the loss (C * weight)
+  // and in the average (it lasts `weight` timesteps)
+  bool update(const Eigen::VectorXd& feature, const int label, const double weight) {
+    const auto loss = suffer_loss(feature, label);
+    const auto timestep = _timestep;
+    _timestep += weight;
+    const auto norm = feature.squaredNorm();
+
+    if (loss <= 0.0 || norm <= 0.0) { return false; }
+
+    const auto tau = _compute_tau(norm, loss, kC * weight);
+    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
+                         [&](const std::size_t index, const double value) {
+                           if (value == 0.0) { return; }
+                           const auto delta = tau * label * value;
+                           _weight[index] += delta;
+                           _accumulated[index] += timestep * delta;
+                         });
+
+    return true;
+  }
+
+  // margin of the averaged model
+  double compute_margin(const Eigen::VectorXd& x) const {
+    if (_timestep == 0) { return _weight.dot(x); }
+    return _weight.dot(x) - _accumulated.dot(x) / _timestep;
+  }
+
+  int predict(const Eigen::VectorXd& x) const {
+    return compute_margin(x) > 0.0 ? 1 : -1;
+  }
+
+  Eigen::VectorXd get_weight(void) const {
+    if (_timestep == 0) { return _weight; }
+    return _weight - _accumulated / _timestep;
+  }
+
+  // continues the training of a model saved with the same dimension and hyper parameters
+  void warm_start(const std::string& filename) {
+    functions::check_readable(filename);
+    AVERAGED_PA saved(*this);
+    saved.load(filename);
+    functions::check_compatible("dimension", kDim, saved.kDim);
+    functions::check_compatible("C", kC, saved.kC);
+    _timestep = saved._timestep;
+    _weight = saved._weight;
+    _accumulated = saved._accumulated;
+  }
+
+  // weighted average with a model trained on other data : the weights and their averages become
+  // (1 - weight) * this + weight * other, and the average goes on over the examples of both models
+  void merge(const AVERAGED_PA& other, const double weight = 0.5) {
+    functions::check_compatible("dimension", kDim, other.kDim);
+    Eigen::VectorXd average = get_weight();
+    functions::merge_average(average, other.get_weight(), weight);
+    functions::merge_average(_weight, other._weight, weight);
+    _timestep += other._timestep;
+    _accumulated = _timestep * (_weight - average);
+  }
+
+  void save(const std::string& filename) {
+    std::ofstream ofs(filename);
+    assert(ofs);
+    boost::archive::text_oarchive oa(ofs);
+    oa << *this;
+    ofs.close();
+  }
+
+  void load(const std::string& filename) {
+    std::ifstream ifs(filename);
+    assert(ifs);
+    boost::archive::text_iarchive ia(ifs);
+    ia >> *this;
+    ifs.close();
+  }
+
+private :
+  friend class boost::serialization::access;
+  BOOST_SERIALIZATION_SPLIT_MEMBER();
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const {
+    std::vector<double> weight(_weight.data(), _weight.data() + _weight.size());
+    std::vector<double> accumulated(_accumulated.data(), _accumulated.data() + _accumulated.size());
+    ar & boost::serialization::make_nvp("weight", weight);
+    ar & boost::serialization::make_nvp("accumulated", accumulated);
+    ar & boost::serialization::make_nvp("timestep", const_cast<double&>(_timestep));
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("C", const_cast<double&>(kC));
+  }
+
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version) {
+    std::vector<double> weight;
+    std::vector<double> accumulated;
+    ar & boost::serialization::make_nvp("weight", weight);
+    ar & boost::serialization::make_nvp("accumulated", accumulated);
+    ar & boost::serialization::make_nvp("timestep", _timestep);
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("C", const_cast<double&>(kC));
+    _weight = Eigen::Map<Eigen::VectorXd>(&weight[0], weight.size());
+    _accumulated = Eigen::Map<Eigen::VectorXd>(&accumulated[0], accumulated.size());
+  }
+};
+
+#endif //MOCHIMOCHI_AVERAGED_PA_HPP_
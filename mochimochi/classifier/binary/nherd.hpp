@@ -11,6 +11,8 @@
 #include <fstream>
 #include <functional>
 #include "../../functions/enumerate.hpp"
+#include "../../functions/merge.hpp"
+#include "../../kernel/dispatch.hpp"
 
 class NHERD {
 private :
@@ -23,7 +25,7 @@ private :
   Eigen::VectorXd _means;
 
 private :
-  std::function<double(double, double, double)> _compute_covariance;
+  std::function<double(double, double, double, double)> _compute_covariance;
 
 public :
   NHERD(const std::size_t dim, const double C, const int diagonal = 0)
@@ -43,24 +45,24 @@ public :
     // 3 : Drop covariance
     switch(kDiagonal) {
     case 0 :
-      _compute_covariance = [=](const auto covariance, const auto confidence, const auto value) {
+      _compute_covariance = [](const auto covariance, const auto confidence, const auto value, const auto c) {
         const auto v = covariance * value;
-        return covariance - (v * v * (kC * kC * confidence + 2 * kC) / std::pow((1.0 + kC * confidence), 2));
+        return covariance - (v * v * (c * c * confidence + 2 * c) / std::pow((1.0 + c * confidence), 2));
       };
       break;
     case 1 :
-      _compute_covariance = [=](const auto covariance, const auto confidence, const auto value) {
-        return covariance / std::pow(1.0 + kC * value * value * covariance, 2);
+      _compute_covariance = [](const auto covariance, const auto confidence, const auto value, const auto c) {
+        return covariance / std::pow(1.0 + c * value * value * covariance, 2);
       };
       break;
     case 2 :
-      _compute_covariance = [=](const auto covariance, const auto confidence, const auto value) {
-        return 1.0 / ((1.0 / covariance) + (2 * kC + kC * kC * confidence) * value * value);
+      _compute_covariance = [](const auto covariance, const auto confidence, const auto value, const auto c) {
+        return 1.0 / ((1.0 / covariance) + (2 * c + c * c * confidence) * value * value);
       };
       break;
     case 3 :
-      _compute_covariance = [=](const auto covariance, const auto confidence, const auto value) {
-        const auto v = (std::pow(covariance * value, 2) * (kC * kC * confidence + 2 * kC) / std::pow(1.0 + kC * confidence, 2));
+      _compute_covariance = [](const auto covariance, const auto confidence, const auto value, const auto c) {
+        const auto v = (std::pow(covariance * value, 2) * (c * c * confidence + 2 * c) / std::pow(1.0 + c * confidence, 2));
         return covariance - v;
       };
       break;
@@ -78,37 +80,38 @@ private :
     return margin * label;
   }
 
-  double compute_margin(const Eigen::VectorXd& x) const {
-    return _means.dot(x);
-  }
-
   double compute_confidence(const Eigen::VectorXd& feature) const {
-    auto confidence = 0.0;
-    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
-                         [&](const int index, const double value) {
-                           confidence += _covariances[index] * value * value;
-                         });
-    return confidence;
+    return kernel::confidence(_covariances, feature);
   }
 
 public :
 
   bool update(const Eigen::VectorXd& feature, const int label) {
+    return update(feature, label, 1.0);
+  }
+
+  // importance weight : the loss of the example counts `weight` times (C * weight)
+  bool update(const Eigen::VectorXd& feature, const int label, const double weight) {
     const auto margin = compute_margin(feature);
 
     if (suffer_loss(margin, label) >= 1.0) { return false; }
 
+    const auto c = kC * weight;
     const auto confidence = compute_confidence(feature);
-    const auto alpha = std::max(0.0, 1.0 - label * margin) / (confidence + 1 / kC) ;
+    const auto alpha = std::max(0.0, 1.0 - label * margin) / (confidence + 1 / c) ;
 
     functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
                        [&](const std::size_t index, const double value) {
                          _means[index] += alpha * label * _covariances[index] * value;
-                         _covariances[index] = _compute_covariance(_covariances[index], confidence, value);
+                         _covariances[index] = _compute_covariance(_covariances[index], confidence, value, c);
                        });
     return true;
   }
 
+  double compute_margin(const Eigen::VectorXd& x) const {
+    return kernel::dot(_means, x);
+  }
+
   int predict(const Eigen::VectorXd& x) const {
     return compute_margin(x) > 0.0 ? 1 : -1;
   }
@@ -117,6 +120,24 @@ public :
     return _means;
   }
 
+  // continues the training of a model saved with the same dimension and hyper parameters
+  void warm_start(const std::string& filename) {
+    functions::check_readable(filename);
+    NHERD saved(*this);
+    saved.load(filename);
+    functions::check_compatible("dimension", kDim, saved.kDim);
+    functions::check_compatible("C", kC, saved.kC);
+    _covariances = saved._covariances;
+    _means = saved._means;
+  }
+
+  // precision weighted merge with a model trained on other data,
+  // weight scales the evidence taken from `other` (1 : as much as from this model)
+  void merge(const NHERD& other, const double weight = 1.0) {
+    functions::check_compatible("dimension", kDim, other.kDim);
+    functions::merge_gaussians(_means, _covariances, other._means, other._covariances, weight);
+  }
+
   void save(const std::string& filename) {
     std::ofstream ofs(filename);
     assert(ofs);
@@ -11,6 +11,7 @@
 #include <fstream>
 #include <functional>
 #include "../../functions/enumerate.hpp"
+#include "../../functions/merge.hpp"
 
 class PA {
 private :
@@ -20,7 +21,7 @@ private :
 
 private :
   Eigen::VectorXd _weight;
-  std::function<double(double, double)> _compute_tau;
+  std::function<double(double, double, double)> _compute_tau;
 
 public :
   PA(const std::size_t dim, const double C, const int select = 2)
@@ -38,19 +39,19 @@ public :
     // 2 : PA-2
     switch(kSelect) {
     case 0 :
-      _compute_tau = [](const auto value, const auto loss) {
+      _compute_tau = [](const auto value, const auto loss, const auto) {
         return loss / std::pow(std::abs(value), 2);
       };
       break;
     case 1 :
-      _compute_tau = [=](const auto value, const auto loss) {
+      _compute_tau = [=](const auto value, const auto loss, const auto weight) {
         const auto pa = loss / std::pow(std::abs(value), 2);
-        return std::min(kC, pa);
+        return std::min(kC * weight, pa);
       };
       break;
     case 2 :
-      _compute_tau = [=](const auto value, const auto loss) {
-        return loss / (std::pow(std::abs(value), 2) + 1.0 / 2 * kC );
+      _compute_tau = [=](const auto value, const auto loss, const auto weight) {
+        return loss / (std::pow(std::abs(value), 2) + 1.0 / 2 * kC / weight);
       };
       break;
     default:
@@ -67,23 +68,29 @@ private :
     return std::max(0.0, 1.0 - y * _weight.dot(x));
   }
 
-  double compute_margin(const Eigen::VectorXd& x) const {
-    return _weight.dot(x);
-  }
-
 public :
 
   bool update(const Eigen::VectorXd& feature, const int label) {
+    return update(feature, label, 1.0);
+  }
+
+  // importance weight : the loss of the example counts `weight` times, which relaxes
+  // the aggressiveness bound of PA-1 / PA-2 (PA meets the margin after a single copy anyway)
+  bool update(const Eigen::VectorXd& feature, const int label, const double weight) {
     const auto loss = suffer_loss(feature, label);
     functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
                          [&](const std::size_t index, const double value) {
-                           const auto tau = _compute_tau(value, loss);
+                           const auto tau = _compute_tau(value, loss, weight);
                            _weight[index] += tau * label * value;
                          });
 
     return true;
   }
 
+  double compute_margin(const Eigen::VectorXd& x) const {
+    return _weight.dot(x);
+  }
+
   int predict(const Eigen::VectorXd& x) const {
     return compute_margin(x) > 0.0 ? 1 : -1;
   }
@@ -92,6 +99,28 @@ public :
     return _weight;
   }
 
+  // data parallel training (parallel::Allreduce) : the workers average their weights
+  template <class Reducer>
+  void synchronize(Reducer& reducer) {
+    reducer.average(_weight);
+  }
+
+  // continues the training of a model saved with the same dimension and hyper parameters
+  void warm_start(const std::string& filename) {
+    functions::check_readable(filename);
+    PA saved(*this);
+    saved.load(filename);
+    functions::check_compatible("dimension", kDim, saved.kDim);
+    functions::check_compatible("C", kC, saved.kC);
+    _weight = saved._weight;
+  }
+
+  // weighted average with a model trained on other data : (1 - weight) * this + weight * other
+  void merge(const PA& other, const double weight = 0.5) {
+    functions::check_compatible("dimension", kDim, other.kDim);
+    functions::merge_average(_weight, other._weight, weight);
+  }
+
   void save(const std::string& filename) {
     std::ofstream ofs(filename);
     assert(ofs);
@@ -11,6 +11,9 @@
 #include <boost/archive/text_iarchive.hpp>
 #include <fstream>
 #include "../../functions/enumerate.hpp"
+#include "../../functions/merge.hpp"
+#include "../../kernel/dispatch.hpp"
+#include "../../parallel/shard_pool.hpp"
 
 class SCW {
 private :
@@ -47,18 +50,17 @@ public :
 
 private :
 
-  double suffer_loss(const Eigen::VectorXd& f, const int label) const {
-    const auto confidence = compute_confidence(f);
-    return std::max(0.0, kPhi * std::sqrt(confidence) - label * _means.dot(f));
+  double suffer_loss(const double margin, const double confidence, const int label) const {
+    return std::max(0.0, kPhi * std::sqrt(confidence) - label * margin);
   }
 
   //Proposition 1
-  double compute_alpha(const double m, const double n, const double v, const double ganma) const {
+  double compute_alpha(const double m, const double n, const double v, const double ganma, const double c) const {
     const auto psi = 1.0 + kPhi * kPhi / 2.0;
     const auto zeta = 1.0 + kPhi * kPhi;
     const auto tmp1 = -m * psi + std::sqrt(m * m * std::pow(kPhi, 4.0) / 4.0 + v * kPhi * kPhi * zeta);
     const auto tmp2 = 1.0 / v * zeta * tmp1;
-    return std::min(kC, std::max(0.0, tmp2));
+    return std::min(c, std::max(0.0, tmp2));
   }
 
   double compute_beta(const double alpha, const double v) const {
@@ -66,45 +68,90 @@ private :
     return alpha * kPhi / (std::sqrt(u) + v * alpha * kPhi);
   }
 
-  double compute_confidence(const Eigen::VectorXd& f) const {
-    auto confidence = 0.0;
-    functions::enumerate(f.data(), f.data() + f.size(), 0,
-                       [&](const int index, const double value) {
-                         confidence += _covariances[index] * value * value;
-                       });
-    return confidence;
+  // (alpha * label, beta) of kernel::update
+  std::pair<double, double> compute_step(const double margin, const double confidence, const int label,
+                                         const double weight) const {
+    const auto c = kC * weight;
+    const auto v = confidence;
+    const auto m = label * margin;
+    const auto n = v + 1.0 / 2.0 * c;
+    const auto ganma = kPhi * std::sqrt(kPhi * kPhi * m * m * v * v + 4.0 * n * v * (n + v * kPhi * kPhi));
+    const auto alpha = compute_alpha(m, n, v, ganma, c);
+    return std::make_pair(alpha * label, compute_beta(alpha, ganma));
   }
 
 public :
 
   bool update(const Eigen::VectorXd& feature, const int label) {
-    const auto v = compute_confidence(feature);
-    const auto m = label * _means.dot(feature);
-    const auto n = v + 1.0 / 2.0 * kC;
-    const auto ganma = kPhi * std::sqrt(kPhi * kPhi * m * m * v * v + 4.0 * n * v * (n + v * kPhi * kPhi));
-    const auto alpha = compute_alpha(m, n, v, ganma);
-    const auto beta = compute_beta(alpha, ganma);
+    return update(feature, label, compute_margin(feature), compute_confidence(feature));
+  }
+
+  // importance weight : the loss of the example counts `weight` times (c * weight)
+  bool update(const Eigen::VectorXd& feature, const int label, const double weight) {
+    return update(feature, label, compute_margin(feature), compute_confidence(feature), weight);
+  }
 
-    if (suffer_loss(feature, label) <= 0.0) { return false; }
+  // margin and confidence already computed for this feature (selective sampling)
+  bool update(const Eigen::VectorXd& feature, const int label, const double margin, const double confidence,
+              const double weight = 1.0) {
+    if (suffer_loss(margin, confidence, label) <= 0.0) { return false; }
 
-    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
-                       [&](const int index, const double value) {
-                         const auto v = _covariances[index] * value;
-                         _means[index] += alpha * label * v;
-                         _covariances[index] -= beta * v * v;
-                       });
+    const auto step = compute_step(margin, confidence, label, weight);
+    kernel::update(_means, _covariances, feature, step.first, step.second);
 
     return true;
   }
 
-  int predict(const Eigen::VectorXd& x) {
-    return _means.dot(x) < 0.0 ? -1 : 1;
+  // feature sharded : the margin and the confidence are summed over the shards
+  // of the pool in one pass, then every shard updates its own range
+  bool update(const Eigen::VectorXd& feature, const int label, parallel::ShardPool& pool, const double weight = 1.0) {
+    const auto scored = parallel::sharded_margin_confidence(pool, _means, _covariances, feature);
+    if (suffer_loss(scored.first, scored.second, label) <= 0.0) { return false; }
+
+    const auto step = compute_step(scored.first, scored.second, label, weight);
+    parallel::sharded_update(pool, _means, _covariances, feature, step.first, step.second);
+    return true;
+  }
+
+  double compute_margin(const Eigen::VectorXd& x) const {
+    return kernel::dot(_means, x);
+  }
+
+  double compute_margin(const Eigen::VectorXd& x, parallel::ShardPool& pool) const {
+    return parallel::sharded_dot(pool, _means, x);
+  }
+
+  double compute_confidence(const Eigen::VectorXd& f) const {
+    return kernel::confidence(_covariances, f);
+  }
+
+  int predict(const Eigen::VectorXd& x) const {
+    return compute_margin(x) < 0.0 ? -1 : 1;
   }
 
   Eigen::VectorXd get_means(void) const {
     return _means;
   }
 
+  // continues the training of a model saved with the same dimension and hyper parameters
+  void warm_start(const std::string& filename) {
+    functions::check_readable(filename);
+    SCW saved(*this);
+    saved.load(filename);
+    functions::check_compatible("dimension", kDim, saved.kDim);
+    functions::check_compatible("c", kC, saved.kC);
+    functions::check_compatible("phi", kPhi, saved.kPhi);
+    _covariances = saved._covariances;
+    _means = saved._means;
+  }
+
+  // precision weighted merge with a model trained on other data,
+  // weight scales the evidence taken from `other` (1 : as much as from this model)
+  void merge(const SCW& other, const double weight = 1.0) {
+    functions::check_compatible("dimension", kDim, other.kDim);
+    functions::merge_gaussians(_means, _covariances, other._means, other._covariances, weight);
+  }
+
   void save(const std::string& filename) {
     std::ofstream ofs(filename);
     assert(ofs);
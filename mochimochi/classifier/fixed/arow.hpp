@@ -0,0 +1,151 @@
+#ifndef MOCHIMOCHI_FIXED_AROW_HPP_
+#define MOCHIMOCHI_FIXED_AROW_HPP_
+
+#include <Eigen/Dense>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <fstream>
+#include "../../functions/merge.hpp"
+
+namespace fixed {
+
+  // AROW with the dimension fixed at compile time : the parameters are stored
+  // inline (no heap allocation) and Eigen unrolls and vectorizes the loops.
+  // Meant for small dense models, the file format is the one of ::AROW.
+  template <int Dim>
+  class AROW {
+    static_assert(Dim > 0, "Dimension Error. (Dimension > 0)");
+
+  public :
+    using Vector = Eigen::Matrix<double, Dim, 1>;
+
+  private :
+    const double kR;
+
+  private :
+    Vector _covariances;
+    Vector _means;
+
+  public :
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    explicit AROW(const double r)
+      : kR(r),
+        _covariances(Vector::Ones()),
+        _means(Vector::Zero()) {
+      assert(r > 0);
+    }
+
+    virtual ~AROW() { }
+
+  public :
+
+    bool update(const Vector& feature, const int label) {
+      return update(feature, label, 1.0);
+    }
+
+    // importance weight : the loss of the example counts `weight` times (r / weight)
+    bool update(const Vector& feature, const int label, const double weight) {
+      const auto margin = compute_margin(feature);
+      if (margin * label >= 1.0) { return false; }
+
+      const auto beta = 1.0 / (compute_confidence(feature) + kR / weight);
+      const auto alpha = (1.0 - label * margin) * beta;
+      // a single pass over the parameters, fully unrolled for small Dim
+      for (int i = 0; i < Dim; ++i) {
+        const auto step = _covariances[i] * feature[i];
+        _means[i] += alpha * label * step;
+        _covariances[i] -= beta * step * step;
+      }
+      return true;
+    }
+
+    double compute_margin(const Vector& x) const {
+      return _means.dot(x);
+    }
+
+    double compute_confidence(const Vector& feature) const {
+      return _covariances.dot(feature.cwiseAbs2());
+    }
+
+    int predict(const Vector& x) const {
+      return compute_margin(x) > 0.0 ? 1 : -1;
+    }
+
+    Vector get_means(void) const {
+      return _means;
+    }
+
+    static constexpr std::size_t dimension(void) { return Dim; }
+
+    // continues the training of a model saved with the same dimension and hyper parameters
+    // (by this class or by ::AROW)
+    void warm_start(const std::string& filename) {
+      functions::check_readable(filename);
+      AROW saved(*this);
+      saved.load(filename);
+      functions::check_compatible("r", kR, saved.kR);
+      _covariances = saved._covariances;
+      _means = saved._means;
+    }
+
+    // precision weighted merge with a model trained on other data,
+    // weight scales the evidence taken from `other` (1 : as much as from this model)
+    void merge(const AROW& other, const double weight = 1.0) {
+      functions::merge_gaussians(_means, _covariances, other._means, other._covariances, weight);
+    }
+
+    void save(const std::string& filename) {
+      std::ofstream ofs(filename);
+      assert(ofs);
+      boost::archive::text_oarchive oa(ofs);
+      oa << *this;
+      ofs.close();
+    }
+
+    void load(const std::string& filename) {
+      std::ifstream ifs(filename);
+      assert(ifs);
+      boost::archive::text_iarchive ia(ifs);
+      ia >> *this;
+      ifs.close();
+    }
+
+  private :
+    friend class boost::serialization::access;
+    BOOST_SERIALIZATION_SPLIT_MEMBER();
+    template <class Archive>
+    void save(Archive& ar, const unsigned int version) const {
+      std::vector<double> covariances_vector(_covariances.data(), _covariances.data() + Dim);
+      std::vector<double> means_vector(_means.data(), _means.data() + Dim);
+      std::size_t dim = Dim;
+      ar & boost::serialization::make_nvp("covariances", covariances_vector);
+      ar & boost::serialization::make_nvp("means", means_vector);
+      ar & boost::serialization::make_nvp("dimension", dim);
+      ar & boost::serialization::make_nvp("r", const_cast<double&>(kR));
+    }
+
+    template <class Archive>
+    void load(Archive& ar, const unsigned int version) {
+      std::vector<double> covariances_vector;
+      std::vector<double> means_vector;
+      std::size_t dim;
+      ar & boost::serialization::make_nvp("covariances", covariances_vector);
+      ar & boost::serialization::make_nvp("means", means_vector);
+      ar & boost::serialization::make_nvp("dimension", dim);
+      ar & boost::serialization::make_nvp("r", const_cast<double&>(kR));
+      functions::check_compatible("dimension", static_cast<std::size_t>(Dim), dim);
+      functions::check_compatible("size", dim, covariances_vector.size());
+      functions::check_compatible("size", dim, means_vector.size());
+      _covariances = Eigen::Map<Vector>(&covariances_vector[0]);
+      _means = Eigen::Map<Vector>(&means_vector[0]);
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_FIXED_AROW_HPP_
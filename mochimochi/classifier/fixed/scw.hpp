@@ -0,0 +1,179 @@
+#ifndef MOCHIMOCHI_FIXED_SCW_HPP_
+#define MOCHIMOCHI_FIXED_SCW_HPP_
+
+#include <Eigen/Dense>
+#include <boost/math/special_functions/erf.hpp>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <fstream>
+#include "../../functions/merge.hpp"
+
+namespace fixed {
+
+  // SCW-I with the dimension fixed at compile time (see fixed::AROW),
+  // the file format is the one of ::SCW.
+  template <int Dim>
+  class SCW {
+    static_assert(Dim > 0, "Dimension Error. (Dimension > 0)");
+
+  public :
+    using Vector = Eigen::Matrix<double, Dim, 1>;
+
+  private :
+    const double kC;
+    const double kPhi;
+
+  private :
+    Vector _covariances;
+    Vector _means;
+
+  public :
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    SCW(const double c, const double eta)
+      : kC(c),
+        kPhi(0.5 * (1.0 + boost::math::erf(eta / std::sqrt(2.0)))),
+        _covariances(Vector::Ones()),
+        _means(Vector::Zero()) {
+      assert(c > 0);
+      assert(eta > 0);
+    }
+
+    virtual ~SCW() { }
+
+  private :
+
+    //Proposition 1
+    double compute_alpha(const double m, const double v, const double c) const {
+      const auto psi = 1.0 + kPhi * kPhi / 2.0;
+      const auto zeta = 1.0 + kPhi * kPhi;
+      const auto tmp1 = -m * psi + std::sqrt(m * m * std::pow(kPhi, 4.0) / 4.0 + v * kPhi * kPhi * zeta);
+      const auto tmp2 = 1.0 / v * zeta * tmp1;
+      return std::min(c, std::max(0.0, tmp2));
+    }
+
+    double compute_beta(const double alpha, const double v) const {
+      const auto u = std::pow(-alpha * v * kPhi + std::sqrt(alpha * alpha * v * v * kPhi * kPhi + 4.0 * v), 2.0) / 4.0;
+      return alpha * kPhi / (std::sqrt(u) + v * alpha * kPhi);
+    }
+
+  public :
+
+    bool update(const Vector& feature, const int label) {
+      return update(feature, label, 1.0);
+    }
+
+    // importance weight : the loss of the example counts `weight` times (c * weight)
+    bool update(const Vector& feature, const int label, const double weight) {
+      const auto margin = compute_margin(feature);
+      const auto confidence = compute_confidence(feature);
+      if (kPhi * std::sqrt(confidence) - label * margin <= 0.0) { return false; }
+
+      const auto v = confidence;
+      const auto m = label * margin;
+      const auto c = kC * weight;
+      const auto n = v + 1.0 / 2.0 * c;
+      const auto ganma = kPhi * std::sqrt(kPhi * kPhi * m * m * v * v + 4.0 * n * v * (n + v * kPhi * kPhi));
+      const auto alpha = compute_alpha(m, v, c);
+      const auto beta = compute_beta(alpha, ganma);
+      // a single pass over the parameters, fully unrolled for small Dim
+      for (int i = 0; i < Dim; ++i) {
+        const auto step = _covariances[i] * feature[i];
+        _means[i] += alpha * label * step;
+        _covariances[i] -= beta * step * step;
+      }
+      return true;
+    }
+
+    double compute_margin(const Vector& x) const {
+      return _means.dot(x);
+    }
+
+    double compute_confidence(const Vector& feature) const {
+      return _covariances.dot(feature.cwiseAbs2());
+    }
+
+    int predict(const Vector& x) const {
+      return compute_margin(x) < 0.0 ? -1 : 1;
+    }
+
+    Vector get_means(void) const {
+      return _means;
+    }
+
+    static constexpr std::size_t dimension(void) { return Dim; }
+
+    // continues the training of a model saved with the same dimension and hyper parameters
+    // (by this class or by ::SCW)
+    void warm_start(const std::string& filename) {
+      functions::check_readable(filename);
+      SCW saved(*this);
+      saved.load(filename);
+      functions::check_compatible("c", kC, saved.kC);
+      functions::check_compatible("phi", kPhi, saved.kPhi);
+      _covariances = saved._covariances;
+      _means = saved._means;
+    }
+
+    // precision weighted merge with a model trained on other data,
+    // weight scales the evidence taken from `other` (1 : as much as from this model)
+    void merge(const SCW& other, const double weight = 1.0) {
+      functions::merge_gaussians(_means, _covariances, other._means, other._covariances, weight);
+    }
+
+    void save(const std::string& filename) {
+      std::ofstream ofs(filename);
+      assert(ofs);
+      boost::archive::text_oarchive oa(ofs);
+      oa << *this;
+      ofs.close();
+    }
+
+    void load(const std::string& filename) {
+      std::ifstream ifs(filename);
+      assert(ifs);
+      boost::archive::text_iarchive ia(ifs);
+      ia >> *this;
+      ifs.close();
+    }
+
+  private :
+    friend class boost::serialization::access;
+    BOOST_SERIALIZATION_SPLIT_MEMBER();
+    template <class Archive>
+    void save(Archive& ar, const unsigned int version) const {
+      std::vector<double> covariances_vector(_covariances.data(), _covariances.data() + Dim);
+      std::vector<double> means_vector(_means.data(), _means.data() + Dim);
+      std::size_t dim = Dim;
+      ar & boost::serialization::make_nvp("covariances", covariances_vector);
+      ar & boost::serialization::make_nvp("means", means_vector);
+      ar & boost::serialization::make_nvp("dimension", dim);
+      ar & boost::serialization::make_nvp("phi", const_cast<double&>(kPhi));
+      ar & boost::serialization::make_nvp("c", const_cast<double&>(kC));
+    }
+
+    template <class Archive>
+    void load(Archive& ar, const unsigned int version) {
+      std::vector<double> covariances_vector;
+      std::vector<double> means_vector;
+      std::size_t dim;
+      ar & boost::serialization::make_nvp("covariances", covariances_vector);
+      ar & boost::serialization::make_nvp("means", means_vector);
+      ar & boost::serialization::make_nvp("dimension", dim);
+      ar & boost::serialization::make_nvp("phi", const_cast<double&>(kPhi));
+      ar & boost::serialization::make_nvp("c", const_cast<double&>(kC));
+      functions::check_compatible("dimension", static_cast<std::size_t>(Dim), dim);
+      functions::check_compatible("size", dim, covariances_vector.size());
+      functions::check_compatible("size", dim, means_vector.size());
+      _covariances = Eigen::Map<Vector>(&covariances_vector[0]);
+      _means = Eigen::Map<Vector>(&means_vector[0]);
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_FIXED_SCW_HPP_
@@ -0,0 +1,202 @@
+#ifndef MOCHIMOCHI_LABEL_TREE_HPP_
+#define MOCHIMOCHI_LABEL_TREE_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../../functions/merge.hpp"
+#include "../../functions/top_k.hpp"
+
+// Multi-class learner for large class counts : the labels 1 .. K are the leaves
+// of a balanced binary tree and each of the K - 1 internal nodes is a binary
+// learner deciding between its left (-1) and right (+1) subtree.
+// An update trains the ceil(log2 K) nodes on the path of the correct label,
+// and predict runs a beam search scoring a path by the sum of log sigmoid(+-margin).
+// Labels with adjacent numbers share the most nodes, so similar classes should be numbered close together.
+template <class Learner>
+class LabelTree {
+private :
+  // a child is an internal node (>= 0) or a leaf -label (< 0)
+  struct Node {
+    std::size_t first;
+    std::size_t middle;
+    long left;
+    long right;
+  };
+
+  struct Path {
+    double score;
+    long child;
+  };
+
+private :
+  const std::size_t kClass;
+  const std::size_t kBeam;
+
+private :
+  std::vector<Node> _nodes;
+  std::vector<Learner> _learners;
+
+private :
+
+  long build(const std::size_t first, const std::size_t last) {
+    if (last - first == 1) { return -static_cast<long>(first); }
+    const auto id = static_cast<long>(_nodes.size());
+    const auto middle = first + (last - first) / 2;
+    _nodes.push_back(Node { first, middle, 0, 0 });
+    const auto left = build(first, middle);
+    const auto right = build(middle, last);
+    _nodes[id].left = left;
+    _nodes[id].right = right;
+    return id;
+  }
+
+  static double log_sigmoid(const double z) {
+    return (z > 0.0) ? -std::log1p(std::exp(-z)) : z - std::log1p(std::exp(z));
+  }
+
+public :
+  // args are the arguments of every node learner, e.g. LabelTree<AROW>(n_class, beam, dim, r)
+  template <typename... Args>
+  LabelTree(const std::size_t n_class, const std::size_t beam, const Args&... args)
+    : kClass(n_class),
+      kBeam(beam) {
+    assert(n_class > 1);
+    assert(beam > 0);
+    _nodes.reserve(n_class - 1);
+    build(1, n_class + 1);
+    _learners.reserve(n_class - 1);
+    for (std::size_t i = 0; i + 1 < n_class; ++i) { _learners.emplace_back(args...); }
+  }
+
+  virtual ~LabelTree() { }
+
+public :
+
+  bool update(const Eigen::VectorXd& feature, const std::size_t label) {
+    assert(label > 0 && label <= kClass);
+    auto updated = false;
+    for (long node = 0; node >= 0; ) {
+      const auto right = label >= _nodes[node].middle;
+      updated = _learners[node].update(feature, right ? 1 : -1) || updated;
+      node = right ? _nodes[node].right : _nodes[node].left;
+    }
+    return updated;
+  }
+
+  // importance weight, passed on to the node learners
+  bool update(const Eigen::VectorXd& feature, const std::size_t label, const double weight) {
+    assert(label > 0 && label <= kClass);
+    auto updated = false;
+    for (long node = 0; node >= 0; ) {
+      const auto right = label >= _nodes[node].middle;
+      updated = _learners[node].update(feature, right ? 1 : -1, weight) || updated;
+      node = right ? _nodes[node].right : _nodes[node].left;
+    }
+    return updated;
+  }
+
+  // the k best leaves of the beam search (the beam is widened to k if needed)
+  functions::Ranking predict_topk(const Eigen::VectorXd& feature, const std::size_t k) const {
+    const auto width = std::max(kBeam, k);
+    functions::TopK top(k);
+    std::vector<Path> beam { Path { 0.0, 0 } };
+    std::vector<Path> next;
+    while (!beam.empty()) {
+      next.clear();
+      for (const auto& path : beam) {
+        const auto& node = _nodes[path.child];
+        const auto margin = _learners[path.child].compute_margin(feature);
+        next.push_back(Path { path.score + log_sigmoid(-margin), node.left });
+        next.push_back(Path { path.score + log_sigmoid(margin), node.right });
+      }
+
+      beam.clear();
+      for (const auto& path : next) {
+        if (path.child < 0) {
+          top.push(static_cast<std::size_t>(-path.child), path.score);
+        } else {
+          beam.push_back(path);
+        }
+      }
+      // a path can only lose score further down, so it is dropped once k leaves beat it
+      if (top.full()) {
+        beam.erase(std::remove_if(beam.begin(), beam.end(), [&](const Path& path) { return path.score <= top.threshold(); }),
+                   beam.end());
+      }
+      if (beam.size() > width) {
+        std::partial_sort(beam.begin(), beam.begin() + width, beam.end(),
+                          [](const Path& a, const Path& b) { return a.score > b.score; });
+        beam.resize(width);
+      }
+    }
+    return top.sorted();
+  }
+
+  std::size_t predict(const Eigen::VectorXd& feature) const {
+    return predict_topk(feature, 1).front().first;
+  }
+
+  // log probabilities of every label, O(K) : for evaluation, not for serving
+  Eigen::VectorXd compute_scores(const Eigen::VectorXd& feature) const {
+    Eigen::VectorXd scores(kClass);
+    std::vector<Path> stack { Path { 0.0, 0 } };
+    while (!stack.empty()) {
+      const auto path = stack.back();
+      stack.pop_back();
+      if (path.child < 0) {
+        scores[-path.child - 1] = path.score;
+        continue;
+      }
+      const auto margin = _learners[path.child].compute_margin(feature);
+      stack.push_back(Path { path.score + log_sigmoid(-margin), _nodes[path.child].left });
+      stack.push_back(Path { path.score + log_sigmoid(margin), _nodes[path.child].right });
+    }
+    return scores;
+  }
+
+  std::size_t n_class(void) const { return kClass; }
+
+  std::size_t depth(void) const {
+    std::size_t depth = 0;
+    for (auto n = kClass - 1; n > 0; n >>= 1) { ++depth; }
+    return depth;
+  }
+
+  const Learner& node(const std::size_t i) const { return _learners.at(i); }
+
+  // <filename> holds the class count, then one file per internal node, <filename>.<node>,
+  // in the format of the node learner
+  void save(const std::string& filename) {
+    functions::save_class_count(filename, kClass);
+    for (std::size_t i = 0; i < _learners.size(); ++i) { _learners[i].save(filename + "." + std::to_string(i)); }
+  }
+
+  void load(const std::string& filename) {
+    functions::check_compatible("class", kClass, functions::load_class_count(filename));
+    for (std::size_t i = 0; i < _learners.size(); ++i) { _learners[i].load(filename + "." + std::to_string(i)); }
+  }
+
+  // continues the training of a tree saved with the same class count and node learners ;
+  // nothing changes when a node file is missing or incompatible
+  void warm_start(const std::string& filename) {
+    functions::check_compatible("class", kClass, functions::load_class_count(filename));
+    auto learners = _learners;
+    for (std::size_t i = 0; i < learners.size(); ++i) { learners[i].warm_start(filename + "." + std::to_string(i)); }
+    _learners.swap(learners);
+  }
+
+  // node by node merge, both trees have the same shape ;
+  // the optional weight is the one of Learner::merge (and so is its default)
+  template <typename... Weight>
+  void merge(const LabelTree& other, const Weight... weight) {
+    functions::check_compatible("class", kClass, other.kClass);
+    for (std::size_t i = 0; i < _learners.size(); ++i) { _learners[i].merge(other._learners[i], weight...); }
+  }
+};
+
+#endif //MOCHIMOCHI_LABEL_TREE_HPP_
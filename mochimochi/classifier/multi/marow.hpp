@@ -2,9 +2,12 @@
 #define MOCHIMOCHI_MAROW_HPP_
 
 #include <algorithm>
+#include <string>
 #include <unordered_map>
 #include <boost/range/irange.hpp>
 #include "../binary/arow.hpp"
+#include "../../functions/merge.hpp"
+#include "../../functions/top_k.hpp"
 
 class MAROW {
 private:
@@ -27,19 +30,74 @@ public:
 
 public:
   void update(const Eigen::VectorXd& feature, const std::size_t label) {
+    update(feature, label, 1.0);
+  }
+
+  // importance weight, passed on to every binary learner
+  void update(const Eigen::VectorXd& feature, const std::size_t label, const double weight) {
     for(auto& arow : _arows) {
       const auto t = (arow.first == label) ? 1 : -1;
-      arow.second.update(feature, t);
+      arow.second.update(feature, t, weight);
     }
   }
 
   std::size_t predict(const Eigen::VectorXd& feature) const {
     return std::max_element(_arows.begin(), _arows.end(),
                             [&](const auto& p1, const auto& p2) {
-                              return p1.second.get_means().dot(feature) < p2.second.get_means().dot(feature);
+                              return p1.second.compute_margin(feature) < p2.second.compute_margin(feature);
                             })->first;
   }
 
+  // element (label - 1) holds the score of each class
+  Eigen::VectorXd compute_scores(const Eigen::VectorXd& feature) const {
+    Eigen::VectorXd scores(kClass);
+    for (const auto& p : _arows) {
+      scores[p.first - 1] = p.second.compute_margin(feature);
+    }
+    return scores;
+  }
+
+  // the k best labels with their scores, from the highest
+  functions::Ranking predict_topk(const Eigen::VectorXd& feature, const std::size_t k) const {
+    return functions::top_k(compute_scores(feature), k);
+  }
+
+  // column (label - 1) holds the parameters of each class
+  Eigen::MatrixXd get_means(void) const {
+    const auto dim = _arows.at(1).get_means().size();
+    Eigen::MatrixXd parameters(dim, kClass);
+    for (const auto& p : _arows) {
+      parameters.col(p.first - 1) = p.second.get_means();
+    }
+    return parameters;
+  }
+
+  // <filename> holds the class count, then one file per class, <filename>.<label>, in the format of AROW
+  void save(const std::string& filename) {
+    functions::save_class_count(filename, kClass);
+    for (auto& p : _arows) { p.second.save(filename + "." + std::to_string(p.first)); }
+  }
+
+  void load(const std::string& filename) {
+    functions::check_compatible("class", kClass, functions::load_class_count(filename));
+    for (auto& p : _arows) { p.second.load(filename + "." + std::to_string(p.first)); }
+  }
+
+  // continues the training of a model saved with the same class count, dimension and hyper parameters ;
+  // nothing changes when a class file is missing or incompatible
+  void warm_start(const std::string& filename) {
+    functions::check_compatible("class", kClass, functions::load_class_count(filename));
+    auto learners = _arows;
+    for (auto& p : learners) { p.second.warm_start(filename + "." + std::to_string(p.first)); }
+    _arows.swap(learners);
+  }
+
+  // class by class precision weighted merge (see AROW::merge)
+  void merge(const MAROW& other, const double weight = 1.0) {
+    functions::check_compatible("class", kClass, other.kClass);
+    for (auto& p : _arows) { p.second.merge(other._arows.at(p.first), weight); }
+  }
+
 };
 
 #endif //MOCHIMOCHI_MAROW_HPP_
@@ -0,0 +1,189 @@
+#ifndef MOCHIMOCHI_MCAROW_HPP_
+#define MOCHIMOCHI_MCAROW_HPP_
+
+#include <Eigen/Dense>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <fstream>
+#include "../../functions/argmax.hpp"
+#include "../../functions/enumerate.hpp"
+#include "../../functions/merge.hpp"
+#include "../../functions/top_k.hpp"
+#include "../../functions/violators.hpp"
+
+// Multi-class AROW with a single prototype per class (Crammer-Singer style).
+// All classes are scored once, and only the correct class and the top_k
+// highest scoring wrong classes that violate the margin are updated.
+class MCAROW {
+private :
+  const std::size_t kDim;
+  const std::size_t kClass;
+  const double kR;
+  const std::size_t kTopK;
+
+private :
+  Eigen::MatrixXd _covariances;
+  Eigen::MatrixXd _means;
+  Eigen::VectorXd _scores;
+  std::vector<std::size_t> _violators;
+
+public :
+  MCAROW(const std::size_t dim, const std::size_t n_class, const double r, const std::size_t top_k = 1)
+    : kDim(dim),
+      kClass(n_class),
+      kR(r),
+      kTopK(top_k),
+      _covariances(Eigen::MatrixXd::Ones(dim, n_class)),
+      _means(Eigen::MatrixXd::Zero(dim, n_class)),
+      _scores(n_class) {
+
+    static_assert(std::numeric_limits<decltype(n_class)>::max() > 2, "Class range Error. (n_class > 2)");
+    assert(dim > 0);
+    assert(n_class > 1);
+    assert(r > 0);
+    assert(top_k > 0);
+    _violators.reserve(n_class);
+  }
+
+  virtual ~MCAROW() { }
+
+private :
+
+  double compute_confidence(const Eigen::VectorXd& feature, const std::size_t correct, const std::size_t wrong) const {
+    auto confidence = 0.0;
+    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
+                         [&](const std::size_t index, const double value) {
+                           confidence += (_covariances(index, correct) + _covariances(index, wrong)) * value * value;
+                         });
+    return confidence;
+  }
+
+  void update_pair(const Eigen::VectorXd& feature, const std::size_t correct, const std::size_t wrong, const double margin,
+                   const double r) {
+    const auto confidence = compute_confidence(feature, correct, wrong);
+    const auto beta = 1.0 / (confidence + r);
+    const auto alpha = std::max(0.0, 1.0 - margin) * beta;
+
+    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
+                         [&](const std::size_t index, const double value) {
+                           if (value == 0.0) { return; }
+                           const auto v_correct = _covariances(index, correct) * value;
+                           const auto v_wrong = _covariances(index, wrong) * value;
+                           _means(index, correct) += alpha * v_correct;
+                           _means(index, wrong) -= alpha * v_wrong;
+                           _covariances(index, correct) -= beta * v_correct * v_correct;
+                           _covariances(index, wrong) -= beta * v_wrong * v_wrong;
+                         });
+  }
+
+public :
+
+  bool update(const Eigen::VectorXd& feature, const std::size_t label) {
+    return update(feature, label, 1.0);
+  }
+
+  // importance weight : the loss of the example counts `weight` times (r / weight)
+  bool update(const Eigen::VectorXd& feature, const std::size_t label, const double weight) {
+    assert(label > 0 && label <= kClass);
+    const std::size_t correct = label - 1;
+    _scores.noalias() = _means.transpose() * feature;
+    functions::find_violators(_scores, correct, kTopK, 1.0, _violators);
+    if (_violators.empty()) { return false; }
+
+    auto correct_score = _scores[correct];
+    for (const auto wrong : _violators) {
+      const auto margin = correct_score - _scores[wrong];
+      if (margin >= 1.0) { continue; }
+      update_pair(feature, correct, wrong, margin, kR / weight);
+      correct_score = _means.col(correct).dot(feature);
+    }
+    return true;
+  }
+
+  Eigen::VectorXd compute_scores(const Eigen::VectorXd& feature) const {
+    return _means.transpose() * feature;
+  }
+
+  // the k best labels with their scores, from the highest
+  functions::Ranking predict_topk(const Eigen::VectorXd& feature, const std::size_t k) const {
+    return functions::top_k(compute_scores(feature), k);
+  }
+
+  std::size_t predict(const Eigen::VectorXd& feature) const {
+    return functions::argmax_score(_means, feature) + 1;
+  }
+
+  Eigen::MatrixXd get_means(void) const {
+    return _means;
+  }
+
+  // continues the training of a model saved with the same dimension and hyper parameters
+  void warm_start(const std::string& filename) {
+    functions::check_readable(filename);
+    MCAROW saved(*this);
+    saved.load(filename);
+    functions::check_compatible("dimension", kDim, saved.kDim);
+    functions::check_compatible("class", kClass, saved.kClass);
+    functions::check_compatible("r", kR, saved.kR);
+    _covariances = saved._covariances;
+    _means = saved._means;
+  }
+
+  // precision weighted merge with a model trained on other data,
+  // weight scales the evidence taken from `other` (1 : as much as from this model)
+  void merge(const MCAROW& other, const double weight = 1.0) {
+    functions::check_compatible("dimension", kDim, other.kDim);
+    functions::check_compatible("class", kClass, other.kClass);
+    functions::merge_gaussians(_means, _covariances, other._means, other._covariances, weight);
+  }
+
+  void save(const std::string& filename) {
+    std::ofstream ofs(filename);
+    assert(ofs);
+    boost::archive::text_oarchive oa(ofs);
+    oa << *this;
+    ofs.close();
+  }
+
+  void load(const std::string& filename) {
+    std::ifstream ifs(filename);
+    assert(ifs);
+    boost::archive::text_iarchive ia(ifs);
+    ia >> *this;
+    ifs.close();
+  }
+
+private :
+  friend class boost::serialization::access;
+  BOOST_SERIALIZATION_SPLIT_MEMBER();
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const {
+    std::vector<double> covariances_vector(_covariances.data(), _covariances.data() + _covariances.size());
+    std::vector<double> means_vector(_means.data(), _means.data() + _means.size());
+    ar & boost::serialization::make_nvp("covariances", covariances_vector);
+    ar & boost::serialization::make_nvp("means", means_vector);
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("class", const_cast<std::size_t&>(kClass));
+    ar & boost::serialization::make_nvp("r", const_cast<double&>(kR));
+  }
+
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version) {
+    std::vector<double> covariances_vector;
+    std::vector<double> means_vector;
+    ar & boost::serialization::make_nvp("covariances", covariances_vector);
+    ar & boost::serialization::make_nvp("means", means_vector);
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("class", const_cast<std::size_t&>(kClass));
+    ar & boost::serialization::make_nvp("r", const_cast<double&>(kR));
+    _covariances = Eigen::Map<Eigen::MatrixXd>(&covariances_vector[0], kDim, kClass);
+    _means = Eigen::Map<Eigen::MatrixXd>(&means_vector[0], kDim, kClass);
+    _scores.resize(kClass);
+  }
+};
+
+#endif //MOCHIMOCHI_MCAROW_HPP_
@@ -0,0 +1,195 @@
+#ifndef MOCHIMOCHI_MCPA_HPP_
+#define MOCHIMOCHI_MCPA_HPP_
+
+#include <Eigen/Dense>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <fstream>
+#include <functional>
+#include "../../functions/argmax.hpp"
+#include "../../functions/enumerate.hpp"
+#include "../../functions/merge.hpp"
+#include "../../functions/top_k.hpp"
+#include "../../functions/violators.hpp"
+
+// Multi-class PA with a single prototype per class (Crammer-Singer style).
+// All classes are scored once, and only the correct class and the top_k
+// highest scoring wrong classes that violate the margin are updated.
+class MCPA {
+private :
+  const std::size_t kDim;
+  const std::size_t kClass;
+  const double kC;
+  const int kSelect;
+  const std::size_t kTopK;
+
+private :
+  Eigen::MatrixXd _weight;
+  Eigen::VectorXd _scores;
+  std::vector<std::size_t> _violators;
+  std::function<double(double, double, double)> _compute_tau;
+
+public :
+  MCPA(const std::size_t dim, const std::size_t n_class, const double C, const int select = 2, const std::size_t top_k = 1)
+    : kDim(dim),
+      kClass(n_class),
+      kC(C),
+      kSelect(select),
+      kTopK(top_k),
+      _weight(Eigen::MatrixXd::Zero(dim, n_class)),
+      _scores(n_class) {
+
+    static_assert(std::numeric_limits<decltype(n_class)>::max() > 2, "Class range Error. (n_class > 2)");
+    assert(dim > 0);
+    assert(n_class > 1);
+    assert(C > 0);
+    assert(top_k > 0);
+    _violators.reserve(n_class);
+
+    // int select : switching the PA algorithm
+    // 0 : PA
+    // 1 : PA-1
+    // 2 : PA-2
+    switch(kSelect) {
+    case 0 :
+      _compute_tau = [](const auto norm, const auto loss, const auto) {
+        return loss / norm;
+      };
+      break;
+    case 1 :
+      _compute_tau = [](const auto norm, const auto loss, const auto c) {
+        return std::min(c, loss / norm);
+      };
+      break;
+    case 2 :
+      _compute_tau = [](const auto norm, const auto loss, const auto c) {
+        return loss / (norm + 1.0 / (2.0 * c));
+      };
+      break;
+    default:
+      throw std::runtime_error("Error in the PA algorithm.");
+    }
+  }
+
+  virtual ~MCPA() { }
+
+private :
+
+  void update_pair(const Eigen::VectorXd& feature, const std::size_t correct, const std::size_t wrong,
+                   const double loss, const double norm, const double c) {
+    const auto tau = _compute_tau(2.0 * norm, loss, c);
+    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
+                         [&](const std::size_t index, const double value) {
+                           if (value == 0.0) { return; }
+                           _weight(index, correct) += tau * value;
+                           _weight(index, wrong) -= tau * value;
+                         });
+  }
+
+public :
+
+  bool update(const Eigen::VectorXd& feature, const std::size_t label) {
+    return update(feature, label, 1.0);
+  }
+
+  // importance weight : the loss of the example counts `weight` times (C * weight)
+  bool update(const Eigen::VectorXd& feature, const std::size_t label, const double weight) {
+    assert(label > 0 && label <= kClass);
+    const std::size_t correct = label - 1;
+    _scores.noalias() = _weight.transpose() * feature;
+    functions::find_violators(_scores, correct, kTopK, 1.0, _violators);
+    if (_violators.empty()) { return false; }
+
+    const auto norm = feature.squaredNorm();
+    if (norm <= 0.0) { return false; }
+
+    auto correct_score = _scores[correct];
+    for (const auto wrong : _violators) {
+      const auto loss = 1.0 - (correct_score - _scores[wrong]);
+      if (loss <= 0.0) { continue; }
+      update_pair(feature, correct, wrong, loss, norm, kC * weight);
+      correct_score = _weight.col(correct).dot(feature);
+    }
+    return true;
+  }
+
+  Eigen::VectorXd compute_scores(const Eigen::VectorXd& feature) const {
+    return _weight.transpose() * feature;
+  }
+
+  // the k best labels with their scores, from the highest
+  functions::Ranking predict_topk(const Eigen::VectorXd& feature, const std::size_t k) const {
+    return functions::top_k(compute_scores(feature), k);
+  }
+
+  std::size_t predict(const Eigen::VectorXd& feature) const {
+    return functions::argmax_score(_weight, feature) + 1;
+  }
+
+  Eigen::MatrixXd get_weight(void) const {
+    return _weight;
+  }
+
+  // continues the training of a model saved with the same dimension and hyper parameters
+  void warm_start(const std::string& filename) {
+    functions::check_readable(filename);
+    MCPA saved(*this);
+    saved.load(filename);
+    functions::check_compatible("dimension", kDim, saved.kDim);
+    functions::check_compatible("class", kClass, saved.kClass);
+    functions::check_compatible("C", kC, saved.kC);
+    _weight = saved._weight;
+  }
+
+  // weighted average with a model trained on other data : (1 - weight) * this + weight * other
+  void merge(const MCPA& other, const double weight = 0.5) {
+    functions::check_compatible("dimension", kDim, other.kDim);
+    functions::check_compatible("class", kClass, other.kClass);
+    functions::merge_average(_weight, other._weight, weight);
+  }
+
+  void save(const std::string& filename) {
+    std::ofstream ofs(filename);
+    assert(ofs);
+    boost::archive::text_oarchive oa(ofs);
+    oa << *this;
+    ofs.close();
+  }
+
+  void load(const std::string& filename) {
+    std::ifstream ifs(filename);
+    assert(ifs);
+    boost::archive::text_iarchive ia(ifs);
+    ia >> *this;
+    ifs.close();
+  }
+
+private :
+  friend class boost::serialization::access;
+  BOOST_SERIALIZATION_SPLIT_MEMBER();
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const {
+    std::vector<double> weight(_weight.data(), _weight.data() + _weight.size());
+    ar & boost::serialization::make_nvp("weight", weight);
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("class", const_cast<std::size_t&>(kClass));
+    ar & boost::serialization::make_nvp("C", const_cast<double&>(kC));
+  }
+
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version) {
+    std::vector<double> weight;
+    ar & boost::serialization::make_nvp("weight", weight);
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("class", const_cast<std::size_t&>(kClass));
+    ar & boost::serialization::make_nvp("C", const_cast<double&>(kC));
+    _weight = Eigen::Map<Eigen::MatrixXd>(&weight[0], kDim, kClass);
+    _scores.resize(kClass);
+  }
+};
+
+#endif //MOCHIMOCHI_MCPA_HPP_
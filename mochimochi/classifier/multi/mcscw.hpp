@@ -0,0 +1,220 @@
+#ifndef MOCHIMOCHI_MCSCW_HPP_
+#define MOCHIMOCHI_MCSCW_HPP_
+
+#include <Eigen/Dense>
+#include <boost/math/special_functions/erf.hpp>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <fstream>
+#include "../../functions/argmax.hpp"
+#include "../../functions/enumerate.hpp"
+#include "../../functions/merge.hpp"
+#include "../../functions/top_k.hpp"
+#include "../../functions/violators.hpp"
+
+// Multi-class SCW-I with a single prototype per class (Crammer-Singer style).
+// All classes are scored once, and only the correct class and the top_k
+// highest scoring wrong classes that violate the margin are updated.
+class MCSCW {
+private :
+  const std::size_t kDim;
+  const std::size_t kClass;
+  const double kC;
+  const double kPhi;
+  const std::size_t kTopK;
+
+private :
+  Eigen::MatrixXd _covariances;
+  Eigen::MatrixXd _means;
+  Eigen::VectorXd _scores;
+  std::vector<std::size_t> _violators;
+
+private :
+  // φ = Φ^-1(η)
+  inline double inverse_cdf(const double p) const {
+    return std::sqrt(2.0) * boost::math::erf_inv(2.0 * p - 1.0);
+  }
+
+public :
+  MCSCW(const std::size_t dim, const std::size_t n_class, const double c, const double eta, const std::size_t top_k = 1)
+    : kDim(dim),
+      kClass(n_class),
+      kC(c),
+      kPhi(inverse_cdf(eta)),
+      kTopK(top_k),
+      _covariances(Eigen::MatrixXd::Ones(dim, n_class)),
+      _means(Eigen::MatrixXd::Zero(dim, n_class)),
+      _scores(n_class) {
+
+    static_assert(std::numeric_limits<decltype(n_class)>::max() > 2, "Class range Error. (n_class > 2)");
+    assert(dim > 0);
+    assert(n_class > 1);
+    assert(c > 0);
+    assert(eta > 0.5 && eta < 1.0);
+    assert(top_k > 0);
+    _violators.reserve(n_class);
+  }
+
+  virtual ~MCSCW() { }
+
+private :
+
+  //Proposition 1
+  double compute_alpha(const double m, const double v, const double c) const {
+    const auto psi = 1.0 + kPhi * kPhi / 2.0;
+    const auto zeta = 1.0 + kPhi * kPhi;
+    const auto tmp = -m * psi + std::sqrt(m * m * std::pow(kPhi, 4.0) / 4.0 + v * kPhi * kPhi * zeta);
+    return std::min(c, std::max(0.0, tmp / (v * zeta)));
+  }
+
+  double compute_beta(const double alpha, const double v) const {
+    const auto u = std::pow(-alpha * v * kPhi + std::sqrt(alpha * alpha * v * v * kPhi * kPhi + 4.0 * v), 2.0) / 4.0;
+    return alpha * kPhi / (std::sqrt(u) + v * alpha * kPhi);
+  }
+
+  double compute_confidence(const Eigen::VectorXd& feature, const std::size_t correct, const std::size_t wrong) const {
+    auto confidence = 0.0;
+    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
+                         [&](const std::size_t index, const double value) {
+                           confidence += (_covariances(index, correct) + _covariances(index, wrong)) * value * value;
+                         });
+    return confidence;
+  }
+
+  bool update_pair(const Eigen::VectorXd& feature, const std::size_t correct, const std::size_t wrong, const double margin,
+                   const double c) {
+    const auto v = compute_confidence(feature, correct, wrong);
+    if (v <= 0.0 || kPhi * std::sqrt(v) - margin <= 0.0) { return false; }
+
+    const auto alpha = compute_alpha(margin, v, c);
+    const auto beta = compute_beta(alpha, v);
+    if (alpha <= 0.0) { return false; }
+
+    functions::enumerate(feature.data(), feature.data() + feature.size(), 0,
+                         [&](const std::size_t index, const double value) {
+                           if (value == 0.0) { return; }
+                           const auto v_correct = _covariances(index, correct) * value;
+                           const auto v_wrong = _covariances(index, wrong) * value;
+                           _means(index, correct) += alpha * v_correct;
+                           _means(index, wrong) -= alpha * v_wrong;
+                           _covariances(index, correct) -= beta * v_correct * v_correct;
+                           _covariances(index, wrong) -= beta * v_wrong * v_wrong;
+                         });
+    return true;
+  }
+
+public :
+
+  bool update(const Eigen::VectorXd& feature, const std::size_t label) {
+    return update(feature, label, 1.0);
+  }
+
+  // importance weight : the loss of the example counts `weight` times (c * weight)
+  bool update(const Eigen::VectorXd& feature, const std::size_t label, const double weight) {
+    assert(label > 0 && label <= kClass);
+    const std::size_t correct = label - 1;
+    _scores.noalias() = _means.transpose() * feature;
+    // the SCW loss depends on the confidence as well, so every wrong class is a candidate
+    functions::find_violators(_scores, correct, kTopK, std::numeric_limits<double>::infinity(), _violators);
+
+    auto updated = false;
+    auto correct_score = _scores[correct];
+    for (const auto wrong : _violators) {
+      if (update_pair(feature, correct, wrong, correct_score - _scores[wrong], kC * weight)) {
+        correct_score = _means.col(correct).dot(feature);
+        updated = true;
+      }
+    }
+    return updated;
+  }
+
+  Eigen::VectorXd compute_scores(const Eigen::VectorXd& feature) const {
+    return _means.transpose() * feature;
+  }
+
+  // the k best labels with their scores, from the highest
+  functions::Ranking predict_topk(const Eigen::VectorXd& feature, const std::size_t k) const {
+    return functions::top_k(compute_scores(feature), k);
+  }
+
+  std::size_t predict(const Eigen::VectorXd& feature) const {
+    return functions::argmax_score(_means, feature) + 1;
+  }
+
+  Eigen::MatrixXd get_means(void) const {
+    return _means;
+  }
+
+  // continues the training of a model saved with the same dimension and hyper parameters
+  void warm_start(const std::string& filename) {
+    functions::check_readable(filename);
+    MCSCW saved(*this);
+    saved.load(filename);
+    functions::check_compatible("dimension", kDim, saved.kDim);
+    functions::check_compatible("class", kClass, saved.kClass);
+    functions::check_compatible("c", kC, saved.kC);
+    functions::check_compatible("phi", kPhi, saved.kPhi);
+    _covariances = saved._covariances;
+    _means = saved._means;
+  }
+
+  // precision weighted merge with a model trained on other data,
+  // weight scales the evidence taken from `other` (1 : as much as from this model)
+  void merge(const MCSCW& other, const double weight = 1.0) {
+    functions::check_compatible("dimension", kDim, other.kDim);
+    functions::check_compatible("class", kClass, other.kClass);
+    functions::merge_gaussians(_means, _covariances, other._means, other._covariances, weight);
+  }
+
+  void save(const std::string& filename) {
+    std::ofstream ofs(filename);
+    assert(ofs);
+    boost::archive::text_oarchive oa(ofs);
+    oa << *this;
+    ofs.close();
+  }
+
+  void load(const std::string& filename) {
+    std::ifstream ifs(filename);
+    assert(ifs);
+    boost::archive::text_iarchive ia(ifs);
+    ia >> *this;
+    ifs.close();
+  }
+
+private :
+  friend class boost::serialization::access;
+  BOOST_SERIALIZATION_SPLIT_MEMBER();
+  template <class Archive>
+  void save(Archive& ar, const unsigned int version) const {
+    std::vector<double> covariances_vector(_covariances.data(), _covariances.data() + _covariances.size());
+    std::vector<double> means_vector(_means.data(), _means.data() + _means.size());
+    ar & boost::serialization::make_nvp("covariances", covariances_vector);
+    ar & boost::serialization::make_nvp("means", means_vector);
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("class", const_cast<std::size_t&>(kClass));
+    ar & boost::serialization::make_nvp("phi", const_cast<double&>(kPhi));
+    ar & boost::serialization::make_nvp("c", const_cast<double&>(kC));
+  }
+
+  template <class Archive>
+  void load(Archive& ar, const unsigned int version) {
+    std::vector<double> covariances_vector;
+    std::vector<double> means_vector;
+    ar & boost::serialization::make_nvp("covariances", covariances_vector);
+    ar & boost::serialization::make_nvp("means", means_vector);
+    ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+    ar & boost::serialization::make_nvp("class", const_cast<std::size_t&>(kClass));
+    ar & boost::serialization::make_nvp("phi", const_cast<double&>(kPhi));
+    ar & boost::serialization::make_nvp("c", const_cast<double&>(kC));
+    _covariances = Eigen::Map<Eigen::MatrixXd>(&covariances_vector[0], kDim, kClass);
+    _means = Eigen::Map<Eigen::MatrixXd>(&means_vector[0], kDim, kClass);
+    _scores.resize(kClass);
+  }
+};
+
+#endif //MOCHIMOCHI_MCSCW_HPP_
@@ -0,0 +1,154 @@
+#ifndef MOCHIMOCHI_SKETCHED_AROW_HPP_
+#define MOCHIMOCHI_SKETCHED_AROW_HPP_
+
+#include <Eigen/Dense>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <fstream>
+#include "../../functions/merge.hpp"
+#include "./covariance.hpp"
+
+namespace sketched {
+
+  // AROW with a rank k plus diagonal covariance (see sketched::Covariance) instead of
+  // the diagonal one : the correlations of the features are learned at O(d k) per update.
+  // Every update moves all the means (Σ x is dense).
+  class AROW {
+  private :
+    const std::size_t kDim;
+    const double kR;
+
+  private :
+    Covariance _covariance;
+    Covariance::Projection _projection;
+    Eigen::VectorXd _means;
+
+  public :
+    AROW(const std::size_t dim, const std::size_t rank, const double r)
+      : kDim(dim),
+        kR(r),
+        _covariance(dim, rank),
+        _means(Eigen::VectorXd::Zero(dim)) {
+      assert(dim > 0);
+      assert(rank > 0);
+      assert(r > 0);
+    }
+
+    virtual ~AROW() { }
+
+  private :
+
+    double suffer_loss(const double margin, const int label) const {
+      return margin * label;
+    }
+
+  public :
+
+    bool update(const Eigen::VectorXd& feature, const int label) {
+      return update(feature, label, 1.0);
+    }
+
+    // importance weight : the loss of the example counts `weight` times (r / weight)
+    bool update(const Eigen::VectorXd& feature, const int label, const double weight) {
+      const auto margin = compute_margin(feature);
+      if (suffer_loss(margin, label) >= 1.0) { return false; }
+
+      const auto confidence = _covariance.project(feature, _projection);
+      const auto beta = 1.0 / (confidence + kR / weight);
+      const auto alpha = std::max(0.0, 1.0 - label * margin) * beta;
+
+      _covariance.update(_means, feature, _projection, alpha * label, beta);
+      return true;
+    }
+
+    double compute_margin(const Eigen::VectorXd& x) const {
+      return _means.dot(x);
+    }
+
+    double compute_confidence(const Eigen::VectorXd& feature) const {
+      return _covariance.confidence(feature);
+    }
+
+    int predict(const Eigen::VectorXd& x) const {
+      return compute_margin(x) > 0.0 ? 1 : -1;
+    }
+
+    Eigen::VectorXd get_means(void) const {
+      return _means;
+    }
+
+    // continues the training of a model saved with the same dimension, rank and hyper parameters
+    void warm_start(const std::string& filename) {
+      functions::check_readable(filename);
+      AROW saved(*this);
+      saved.load(filename);
+      functions::check_compatible("dimension", kDim, saved.kDim);
+      functions::check_compatible("rank", _covariance.rank(), saved._covariance.rank());
+      functions::check_compatible("r", kR, saved.kR);
+      _covariance = saved._covariance;
+      _means = saved._means;
+    }
+
+    // precision weighted merge with a model trained on other data (see ::AROW::merge),
+    // weight scales the evidence taken from `other` ; the sketch of `other` is folded into this one
+    void merge(const AROW& other, const double weight = 1.0) {
+      functions::check_compatible("dimension", kDim, other.kDim);
+      const Eigen::VectorXd evidence = _covariance.precision(_means) + weight * other._covariance.precision(other._means);
+      _covariance.merge(other._covariance, weight);
+      _means = _covariance.apply(evidence);
+    }
+
+    void save(const std::string& filename) {
+      std::ofstream ofs(filename);
+      assert(ofs);
+      boost::archive::text_oarchive oa(ofs);
+      oa << *this;
+      ofs.close();
+    }
+
+    void load(const std::string& filename) {
+      std::ifstream ifs(filename);
+      assert(ifs);
+      boost::archive::text_iarchive ia(ifs);
+      ia >> *this;
+      ifs.close();
+    }
+
+  private :
+    friend class boost::serialization::access;
+    BOOST_SERIALIZATION_SPLIT_MEMBER();
+    template <class Archive>
+    void save(Archive& ar, const unsigned int version) const {
+      std::vector<double> covariance_vector = _covariance.state();
+      std::vector<double> means_vector(_means.data(), _means.data() + _means.size());
+      std::size_t rank = _covariance.rank();
+      ar & boost::serialization::make_nvp("covariance", covariance_vector);
+      ar & boost::serialization::make_nvp("means", means_vector);
+      ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+      ar & boost::serialization::make_nvp("rank", rank);
+      ar & boost::serialization::make_nvp("r", const_cast<double&>(kR));
+    }
+
+    template <class Archive>
+    void load(Archive& ar, const unsigned int version) {
+      std::vector<double> covariance_vector;
+      std::vector<double> means_vector;
+      std::size_t rank;
+      ar & boost::serialization::make_nvp("covariance", covariance_vector);
+      ar & boost::serialization::make_nvp("means", means_vector);
+      ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+      ar & boost::serialization::make_nvp("rank", rank);
+      ar & boost::serialization::make_nvp("r", const_cast<double&>(kR));
+      _covariance = Covariance(kDim, rank);
+      _covariance.restore(covariance_vector);
+      _means = Eigen::Map<Eigen::VectorXd>(&means_vector[0], means_vector.size());
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_SKETCHED_AROW_HPP_
@@ -0,0 +1,270 @@
+#ifndef MOCHIMOCHI_SKETCHED_COVARIANCE_HPP_
+#define MOCHIMOCHI_SKETCHED_COVARIANCE_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace sketched {
+
+  // Covariance of a confidence weighted learner kept as a low rank plus diagonal precision,
+  // Σ^-1 = D + S^T S. The rank one precision updates (c x x^T) of AROW / SCW are appended
+  // to S, a Frequent Directions sketch of 2k rows shrunk to its k main directions when full
+  // (Liberty, Simple and Deterministic Matrix Sketching), and the mass a shrink removes
+  // is added to D on the diagonal, so no feature loses its precision.
+  // Σ x is applied with the Woodbury identity, Σ = D^-1 - D^-1 S^T (I + S D^-1 S^T)^-1 S D^-1,
+  // which costs O(d k + k^2) per update ; the shrinks, O(d k^2 + k^3), happen every k updates,
+  // so the rank should stay well below the dimension.
+  class Covariance {
+  public :
+    // x projected once and shared by the confidence and the update
+    struct Projection {
+      Eigen::VectorXd scaled;   // D^-1 x
+      Eigen::VectorXd sketched; // S D^-1 x
+      Eigen::VectorXd solved;   // (I + S D^-1 S^T)^-1 S D^-1 x
+      double confidence;        // x^T Σ x
+    };
+
+  private :
+    using Rows = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  private :
+    // not const : the learners assign a loaded covariance
+    std::size_t _dim;
+    std::size_t _rank;
+    Eigen::VectorXd _diagonal;
+    Rows _sketch;
+    std::size_t _rows;
+    // I + S D^-1 S^T (identity on the empty rows) and its Cholesky factor
+    Eigen::MatrixXd _inner;
+    Eigen::MatrixXd _lower;
+
+  private :
+
+    // the small 2k x 2k decompositions are written out : Eigen's LLT and
+    // SelfAdjointEigenSolver trip -Wmaybe-uninitialized in some GCC versions
+
+    // cyclic Jacobi rotations, a becomes diagonal (the eigenvalues) and vectors holds the eigenvectors
+    static void diagonalize(Eigen::MatrixXd& a, Eigen::MatrixXd& vectors) {
+      const auto n = a.rows();
+      vectors.setIdentity(n, n);
+      for (int sweep = 0; sweep < 64; ++sweep) {
+        auto off = 0.0;
+        for (Eigen::Index p = 0; p < n; ++p) {
+          for (Eigen::Index q = p + 1; q < n; ++q) { off += a(p, q) * a(p, q); }
+        }
+        if (off <= 1e-30 * a.squaredNorm()) { return; }
+
+        for (Eigen::Index p = 0; p < n; ++p) {
+          for (Eigen::Index q = p + 1; q < n; ++q) {
+            if (a(p, q) == 0.0) { continue; }
+            const auto theta = (a(q, q) - a(p, p)) / (2.0 * a(p, q));
+            const auto t = std::copysign(1.0, theta) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+            const auto c = 1.0 / std::sqrt(t * t + 1.0);
+            const auto s = t * c;
+            for (Eigen::Index k = 0; k < n; ++k) {
+              const auto kp = a(k, p), kq = a(k, q);
+              a(k, p) = c * kp - s * kq;
+              a(k, q) = s * kp + c * kq;
+            }
+            for (Eigen::Index k = 0; k < n; ++k) {
+              const auto pk = a(p, k), qk = a(q, k);
+              a(p, k) = c * pk - s * qk;
+              a(q, k) = s * pk + c * qk;
+            }
+            for (Eigen::Index k = 0; k < n; ++k) {
+              const auto kp = vectors(k, p), kq = vectors(k, q);
+              vectors(k, p) = c * kp - s * kq;
+              vectors(k, q) = s * kp + c * kq;
+            }
+          }
+        }
+      }
+    }
+
+    void factorize(void) {
+      const auto n = _inner.rows();
+      _lower.setZero(n, n);
+      for (Eigen::Index j = 0; j < n; ++j) {
+        auto diagonal = _inner(j, j);
+        for (Eigen::Index k = 0; k < j; ++k) { diagonal -= _lower(j, k) * _lower(j, k); }
+        _lower(j, j) = std::sqrt(diagonal);
+        for (Eigen::Index i = j + 1; i < n; ++i) {
+          auto value = _inner(i, j);
+          for (Eigen::Index k = 0; k < j; ++k) { value -= _lower(i, k) * _lower(j, k); }
+          _lower(i, j) = value / _lower(j, j);
+        }
+      }
+    }
+
+    // (L L^T)^-1 b, in place
+    void solve(Eigen::VectorXd& b) const {
+      const auto n = _lower.rows();
+      for (Eigen::Index i = 0; i < n; ++i) {
+        for (Eigen::Index k = 0; k < i; ++k) { b[i] -= _lower(i, k) * b[k]; }
+        b[i] /= _lower(i, i);
+      }
+      for (Eigen::Index i = n - 1; i >= 0; --i) {
+        for (Eigen::Index k = i + 1; k < n; ++k) { b[i] -= _lower(k, i) * b[k]; }
+        b[i] /= _lower(i, i);
+      }
+    }
+
+    // S D^-1 x, zero on the empty rows
+    void sketch(Projection& projection) const {
+      projection.sketched.setZero(_sketch.rows());
+      projection.sketched.head(_rows).noalias() = _sketch.topRows(_rows) * projection.scaled;
+    }
+
+    // keeps the k main directions of S, shrunk by the (k + 1)-th squared singular value
+    void shrink(void) {
+      Eigen::MatrixXd outer = _sketch * _sketch.transpose();
+      Eigen::MatrixXd vectors;
+      diagonalize(outer, vectors);
+      std::vector<Eigen::Index> order(outer.rows());
+      for (Eigen::Index i = 0; i < outer.rows(); ++i) { order[i] = i; }
+      std::sort(order.begin(), order.end(), [&](const Eigen::Index a, const Eigen::Index b) { return outer(a, a) > outer(b, b); });
+      const auto delta = std::max(0.0, outer(order[_rank], order[_rank]));
+
+      Rows shrunk = Rows::Zero(_sketch.rows(), _dim);
+      std::size_t rows = 0;
+      for (std::size_t j = 0; j < _rank; ++j) {
+        const auto value = outer(order[j], order[j]);
+        if (value <= delta) { break; }
+        shrunk.row(rows++) = std::sqrt((value - delta) / value) * (vectors.col(order[j]).transpose() * _sketch);
+      }
+
+      _diagonal += (_sketch.colwise().squaredNorm() - shrunk.colwise().squaredNorm()).transpose().cwiseMax(0.0);
+      _sketch.swap(shrunk);
+      _rows = rows;
+      refresh();
+    }
+
+  public :
+    Covariance(const std::size_t dim, const std::size_t rank)
+      : _dim(dim),
+        _rank(rank),
+        _diagonal(Eigen::VectorXd::Ones(dim)),
+        _sketch(Rows::Zero(2 * rank, dim)),
+        _rows(0) {
+      assert(dim > 0);
+      assert(rank > 0);
+      refresh();
+    }
+
+  public :
+
+    // rebuilds I + S D^-1 S^T after D or S changed
+    void refresh(void) {
+      const Rows scaled = _sketch.topRows(_rows) * _diagonal.cwiseInverse().asDiagonal();
+      _inner = Eigen::MatrixXd::Identity(_sketch.rows(), _sketch.rows());
+      _inner.topLeftCorner(_rows, _rows) += scaled * _sketch.topRows(_rows).transpose();
+      factorize();
+    }
+
+    double project(const Eigen::VectorXd& x, Projection& projection) const {
+      projection.scaled = x.cwiseQuotient(_diagonal);
+      sketch(projection);
+      projection.solved = projection.sketched;
+      solve(projection.solved);
+      projection.confidence = x.dot(projection.scaled) - projection.sketched.dot(projection.solved);
+      return projection.confidence;
+    }
+
+    double confidence(const Eigen::VectorXd& x) const {
+      Projection projection;
+      return project(x, projection);
+    }
+
+    // means += alpha Σ x ; Σ -= beta Σ x x^T Σ, i.e. Σ^-1 += c x x^T with c = beta / (1 - beta x^T Σ x)
+    void update(Eigen::VectorXd& means, const Eigen::VectorXd& x, Projection& projection,
+                const double alpha, const double beta) {
+      means += alpha * (projection.scaled -
+                        (_sketch.topRows(_rows).transpose() * projection.solved.head(_rows)).cwiseQuotient(_diagonal));
+
+      const auto c = beta / (1.0 - beta * projection.confidence);
+      if (!(c > 0.0) || !std::isfinite(c)) { return; }
+      if (_rows == static_cast<std::size_t>(_sketch.rows())) {
+        shrink();
+        projection.scaled = x.cwiseQuotient(_diagonal);
+        sketch(projection);
+      }
+
+      // the new row of I + S D^-1 S^T only adds a row to its Cholesky factor
+      const auto root = std::sqrt(c);
+      const auto n = _rows;
+      _sketch.row(n) = root * x.transpose();
+      _inner.block(n, 0, 1, n) = root * projection.sketched.head(n).transpose();
+      _inner.block(0, n, n, 1) = root * projection.sketched.head(n);
+      _inner(n, n) = 1.0 + c * x.dot(projection.scaled);
+      auto diagonal = _inner(n, n);
+      for (std::size_t i = 0; i < n; ++i) {
+        auto value = _inner(n, i);
+        for (std::size_t k = 0; k < i; ++k) { value -= _lower(n, k) * _lower(i, k); }
+        _lower(n, i) = value / _lower(i, i);
+        diagonal -= _lower(n, i) * _lower(n, i);
+      }
+      _lower(n, n) = std::sqrt(diagonal);
+      ++_rows;
+    }
+
+    // Σ^-1 v = D v + S^T S v
+    Eigen::VectorXd precision(const Eigen::VectorXd& v) const {
+      return _diagonal.cwiseProduct(v) + _sketch.topRows(_rows).transpose() * (_sketch.topRows(_rows) * v);
+    }
+
+    // Σ v
+    Eigen::VectorXd apply(const Eigen::VectorXd& v) const {
+      Projection projection;
+      project(v, projection);
+      return projection.scaled -
+        (_sketch.topRows(_rows).transpose() * projection.solved.head(_rows)).cwiseQuotient(_diagonal);
+    }
+
+    // adds the evidence of a covariance learned on other data, Σ^-1 += weight (other^-1 - I)
+    // (both started from the N(0, I) prior) ; its rows go through the sketch like updates
+    void merge(const Covariance& other, const double weight) {
+      assert(other._dim == _dim);
+      _diagonal += weight * (other._diagonal.array() - 1.0).matrix();
+      for (std::size_t i = 0; i < other._rows; ++i) {
+        if (_rows == static_cast<std::size_t>(_sketch.rows())) { shrink(); }
+        _sketch.row(_rows++) = std::sqrt(weight) * other._sketch.row(i);
+      }
+      refresh();
+    }
+
+    std::size_t dimension(void) const { return _dim; }
+
+    std::size_t rank(void) const { return _rank; }
+
+    // diagonal of the precision, D + S^T S
+    Eigen::VectorXd precisions(void) const {
+      return _diagonal + _sketch.colwise().squaredNorm().transpose();
+    }
+
+    // flat state for the learners' serialization : D, then the 2k rows of S
+    std::vector<double> state(void) const {
+      std::vector<double> values(_diagonal.data(), _diagonal.data() + _dim);
+      for (Eigen::Index i = 0; i < _sketch.rows(); ++i) {
+        for (std::size_t j = 0; j < _dim; ++j) { values.push_back(_sketch(i, j)); }
+      }
+      values.push_back(static_cast<double>(_rows));
+      return values;
+    }
+
+    void restore(const std::vector<double>& values) {
+      assert(values.size() == _dim * (1 + _sketch.rows()) + 1);
+      std::copy(values.begin(), values.begin() + _dim, _diagonal.data());
+      for (Eigen::Index i = 0; i < _sketch.rows(); ++i) {
+        for (std::size_t j = 0; j < _dim; ++j) { _sketch(i, j) = values[_dim * (1 + i) + j]; }
+      }
+      _rows = static_cast<std::size_t>(values.back());
+      refresh();
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_SKETCHED_COVARIANCE_HPP_
@@ -0,0 +1,178 @@
+#ifndef MOCHIMOCHI_SKETCHED_SCW_HPP_
+#define MOCHIMOCHI_SKETCHED_SCW_HPP_
+
+#include <Eigen/Dense>
+#include <boost/math/special_functions/erf.hpp>
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <fstream>
+#include "../../functions/merge.hpp"
+#include "./covariance.hpp"
+
+namespace sketched {
+
+  // SCW-I with a rank k plus diagonal covariance (see sketched::AROW)
+  class SCW {
+  private :
+    const std::size_t kDim;
+    const double kC;
+    const double kPhi;
+
+  private :
+    Covariance _covariance;
+    Covariance::Projection _projection;
+    Eigen::VectorXd _means;
+
+  public :
+    SCW(const std::size_t dim, const std::size_t rank, const double c, const double eta)
+      : kDim(dim),
+        kC(c),
+        kPhi(0.5 * (1.0 + boost::math::erf(eta / std::sqrt(2.0)))),
+        _covariance(dim, rank),
+        _means(Eigen::VectorXd::Zero(dim)) {
+      assert(dim > 0);
+      assert(rank > 0);
+      assert(c > 0);
+      assert(eta > 0);
+    }
+
+    virtual ~SCW() { }
+
+  private :
+
+    double suffer_loss(const double margin, const double confidence, const int label) const {
+      return std::max(0.0, kPhi * std::sqrt(confidence) - label * margin);
+    }
+
+    //Proposition 1
+    double compute_alpha(const double m, const double v, const double c) const {
+      const auto psi = 1.0 + kPhi * kPhi / 2.0;
+      const auto zeta = 1.0 + kPhi * kPhi;
+      const auto tmp1 = -m * psi + std::sqrt(m * m * std::pow(kPhi, 4.0) / 4.0 + v * kPhi * kPhi * zeta);
+      const auto tmp2 = 1.0 / v * zeta * tmp1;
+      return std::min(c, std::max(0.0, tmp2));
+    }
+
+    double compute_beta(const double alpha, const double v) const {
+      const auto u = std::pow(-alpha * v * kPhi + std::sqrt(alpha * alpha * v * v * kPhi * kPhi + 4.0 * v), 2.0) / 4.0;
+      return alpha * kPhi / (std::sqrt(u) + v * alpha * kPhi);
+    }
+
+  public :
+
+    bool update(const Eigen::VectorXd& feature, const int label) {
+      return update(feature, label, 1.0);
+    }
+
+    // importance weight : the loss of the example counts `weight` times (c * weight)
+    bool update(const Eigen::VectorXd& feature, const int label, const double weight) {
+      const auto margin = compute_margin(feature);
+      const auto confidence = _covariance.project(feature, _projection);
+      if (suffer_loss(margin, confidence, label) <= 0.0) { return false; }
+
+      const auto v = confidence;
+      const auto m = label * margin;
+      const auto c = kC * weight;
+      const auto n = v + 1.0 / 2.0 * c;
+      const auto ganma = kPhi * std::sqrt(kPhi * kPhi * m * m * v * v + 4.0 * n * v * (n + v * kPhi * kPhi));
+      const auto alpha = compute_alpha(m, v, c);
+      const auto beta = compute_beta(alpha, ganma);
+
+      _covariance.update(_means, feature, _projection, alpha * label, beta);
+      return true;
+    }
+
+    double compute_margin(const Eigen::VectorXd& x) const {
+      return _means.dot(x);
+    }
+
+    double compute_confidence(const Eigen::VectorXd& feature) const {
+      return _covariance.confidence(feature);
+    }
+
+    int predict(const Eigen::VectorXd& x) const {
+      return compute_margin(x) < 0.0 ? -1 : 1;
+    }
+
+    Eigen::VectorXd get_means(void) const {
+      return _means;
+    }
+
+    // continues the training of a model saved with the same dimension, rank and hyper parameters
+    void warm_start(const std::string& filename) {
+      functions::check_readable(filename);
+      SCW saved(*this);
+      saved.load(filename);
+      functions::check_compatible("dimension", kDim, saved.kDim);
+      functions::check_compatible("rank", _covariance.rank(), saved._covariance.rank());
+      functions::check_compatible("c", kC, saved.kC);
+      functions::check_compatible("phi", kPhi, saved.kPhi);
+      _covariance = saved._covariance;
+      _means = saved._means;
+    }
+
+    // precision weighted merge with a model trained on other data (see ::SCW::merge),
+    // weight scales the evidence taken from `other` ; the sketch of `other` is folded into this one
+    void merge(const SCW& other, const double weight = 1.0) {
+      functions::check_compatible("dimension", kDim, other.kDim);
+      const Eigen::VectorXd evidence = _covariance.precision(_means) + weight * other._covariance.precision(other._means);
+      _covariance.merge(other._covariance, weight);
+      _means = _covariance.apply(evidence);
+    }
+
+    void save(const std::string& filename) {
+      std::ofstream ofs(filename);
+      assert(ofs);
+      boost::archive::text_oarchive oa(ofs);
+      oa << *this;
+      ofs.close();
+    }
+
+    void load(const std::string& filename) {
+      std::ifstream ifs(filename);
+      assert(ifs);
+      boost::archive::text_iarchive ia(ifs);
+      ia >> *this;
+      ifs.close();
+    }
+
+  private :
+    friend class boost::serialization::access;
+    BOOST_SERIALIZATION_SPLIT_MEMBER();
+    template <class Archive>
+    void save(Archive& ar, const unsigned int version) const {
+      std::vector<double> covariance_vector = _covariance.state();
+      std::vector<double> means_vector(_means.data(), _means.data() + _means.size());
+      std::size_t rank = _covariance.rank();
+      ar & boost::serialization::make_nvp("covariance", covariance_vector);
+      ar & boost::serialization::make_nvp("means", means_vector);
+      ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+      ar & boost::serialization::make_nvp("rank", rank);
+      ar & boost::serialization::make_nvp("phi", const_cast<double&>(kPhi));
+      ar & boost::serialization::make_nvp("c", const_cast<double&>(kC));
+    }
+
+    template <class Archive>
+    void load(Archive& ar, const unsigned int version) {
+      std::vector<double> covariance_vector;
+      std::vector<double> means_vector;
+      std::size_t rank;
+      ar & boost::serialization::make_nvp("covariance", covariance_vector);
+      ar & boost::serialization::make_nvp("means", means_vector);
+      ar & boost::serialization::make_nvp("dimension", const_cast<std::size_t&>(kDim));
+      ar & boost::serialization::make_nvp("rank", rank);
+      ar & boost::serialization::make_nvp("phi", const_cast<double&>(kPhi));
+      ar & boost::serialization::make_nvp("c", const_cast<double&>(kC));
+      _covariance = Covariance(kDim, rank);
+      _covariance.restore(covariance_vector);
+      _means = Eigen::Map<Eigen::VectorXd>(&means_vector[0], means_vector.size());
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_SKETCHED_SCW_HPP_
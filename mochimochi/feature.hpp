@@ -0,0 +1,8 @@
+#ifndef MOCHIMOCHI_FEATURE_HPP_
+#define MOCHIMOCHI_FEATURE_HPP_
+
+#include "./feature/expanded.hpp"
+#include "./feature/quadratic_crosses.hpp"
+#include "./feature/random_fourier.hpp"
+
+#endif //MOCHIMOCHI_FEATURE_HPP_
@@ -0,0 +1,70 @@
+#ifndef MOCHIMOCHI_FEATURE_EXPANDED_HPP_
+#define MOCHIMOCHI_FEATURE_EXPANDED_HPP_
+
+#include <Eigen/Dense>
+#include <cassert>
+#include <utility>
+
+namespace feature {
+
+  // Runs every example through a feature map before it reaches the learner.
+  template <class Map, class Learner>
+  class Expanded {
+  private :
+    Map _map;
+    Learner _learner;
+    Eigen::VectorXd _buffer;
+
+  public :
+    Expanded(Map map, Learner learner)
+      : _map(std::move(map)),
+        _learner(std::move(learner)),
+        _buffer(_map.output_dim()) { }
+
+    virtual ~Expanded() { }
+
+  public :
+
+    template <typename Label>
+    auto update(const Eigen::VectorXd& feature, const Label label) -> decltype(_learner.update(feature, label)) {
+      _map.transform(feature, _buffer);
+      return _learner.update(_buffer, label);
+    }
+
+    template <typename Label>
+    auto update(const Eigen::VectorXd& feature, const Label label, const double weight)
+      -> decltype(_learner.update(feature, label, weight)) {
+      _map.transform(feature, _buffer);
+      return _learner.update(_buffer, label, weight);
+    }
+
+    auto predict(const Eigen::VectorXd& feature) const -> decltype(_learner.predict(feature)) {
+      return _learner.predict(_map.transform(feature));
+    }
+
+    template <class L = Learner>
+    auto compute_margin(const Eigen::VectorXd& feature) const -> decltype(std::declval<const L&>().compute_margin(feature)) {
+      return _learner.compute_margin(_map.transform(feature));
+    }
+
+    template <class L = Learner>
+    auto compute_scores(const Eigen::VectorXd& feature) const -> decltype(std::declval<const L&>().compute_scores(feature)) {
+      return _learner.compute_scores(_map.transform(feature));
+    }
+
+    const Map& map(void) const { return _map; }
+
+    Learner& learner(void) { return _learner; }
+
+    const Learner& learner(void) const { return _learner; }
+  };
+
+  template <class Map, class Learner>
+  Expanded<Map, Learner> make_expanded(Map map, Learner learner) {
+    assert(map.output_dim() > 0);
+    return Expanded<Map, Learner>(std::move(map), std::move(learner));
+  }
+
+};
+
+#endif //MOCHIMOCHI_FEATURE_EXPANDED_HPP_
@@ -0,0 +1,115 @@
+#ifndef MOCHIMOCHI_FEATURE_QUADRATIC_CROSSES_HPP_
+#define MOCHIMOCHI_FEATURE_QUADRATIC_CROSSES_HPP_
+
+#include <Eigen/Dense>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace feature {
+
+  // A namespace is a range of input indices, 1-based and inclusive as in the svmlight files.
+  struct Namespace {
+    std::size_t first;
+    std::size_t last;
+  };
+
+  // Pairwise crosses of namespaces computed when the example is read, instead
+  // of being written to the data files : the output keeps the input features
+  // in [0, input_dim) and adds x_i * x_j for every nonzero i, j of each crossed
+  // pair of namespaces, hashed into `buckets` slots after them (the hash also
+  // picks the sign, so that collisions cancel out on average).
+  class QuadraticCrosses {
+  private :
+    const std::size_t kInputDim;
+    const std::size_t kBuckets;
+
+  private :
+    std::vector<Namespace> _namespaces;
+    std::vector<std::pair<std::size_t, std::size_t>> _pairs;
+    // nonzeros of the crossed namespaces, kept between calls as the buffer of Expanded
+    // (a QuadraticCrosses transforms one example at a time)
+    mutable std::vector<std::size_t> _left;
+    mutable std::vector<std::size_t> _right;
+
+  private :
+
+    static std::uint64_t mix(std::uint64_t h) {
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      h ^= h >> 33;
+      return h;
+    }
+
+    void nonzeros(const Eigen::VectorXd& x, const Namespace& ns, std::vector<std::size_t>& indices) const {
+      indices.clear();
+      for (auto i = ns.first - 1; i < ns.last; ++i) {
+        if (x[i] != 0.0) { indices.push_back(i); }
+      }
+    }
+
+  public :
+    QuadraticCrosses(const std::size_t input_dim, const std::size_t buckets)
+      : kInputDim(input_dim),
+        kBuckets(buckets) {
+      assert(buckets > 0);
+    }
+
+  public :
+
+    // returns the id of the namespace, used by cross()
+    std::size_t add_namespace(const std::size_t first, const std::size_t last) {
+      assert(1 <= first && first <= last && last <= kInputDim);
+      _namespaces.push_back(Namespace { first, last });
+      return _namespaces.size() - 1;
+    }
+
+    // a namespace crossed with itself gives every unordered pair of its features
+    void cross(const std::size_t a, const std::size_t b) {
+      assert(a < _namespaces.size() && b < _namespaces.size());
+      assert(_pairs.size() < (1 << 16));
+      _pairs.emplace_back(a, b);
+    }
+
+    void transform(const Eigen::VectorXd& x, Eigen::VectorXd& z) const {
+      assert(static_cast<std::size_t>(x.size()) == kInputDim);
+      z.resize(output_dim());
+      z.head(kInputDim) = x;
+      z.tail(kBuckets).setZero();
+
+      for (std::size_t p = 0; p < _pairs.size(); ++p) {
+        const auto self = _pairs[p].first == _pairs[p].second;
+        nonzeros(x, _namespaces[_pairs[p].first], _left);
+        if (!self) { nonzeros(x, _namespaces[_pairs[p].second], _right); }
+        const auto& others = self ? _left : _right;
+
+        // the indices are mixed one after the other, so that no bit of either is lost
+        for (std::size_t l = 0; l < _left.size(); ++l) {
+          const auto seed = mix(static_cast<std::uint64_t>(p) ^ (static_cast<std::uint64_t>(_left[l]) << 16));
+          for (auto r = self ? l + 1 : 0; r < others.size(); ++r) {
+            const auto h = mix(seed ^ others[r]);
+            const auto sign = (h >> 63) ? -1.0 : 1.0;
+            z[kInputDim + (h % kBuckets)] += sign * x[_left[l]] * x[others[r]];
+          }
+        }
+      }
+    }
+
+    Eigen::VectorXd transform(const Eigen::VectorXd& x) const {
+      Eigen::VectorXd z;
+      transform(x, z);
+      return z;
+    }
+
+    std::size_t input_dim(void) const { return kInputDim; }
+
+    // dimension the learner has to be built with
+    std::size_t output_dim(void) const { return kInputDim + kBuckets; }
+  };
+
+};
+
+#endif //MOCHIMOCHI_FEATURE_QUADRATIC_CROSSES_HPP_
@@ -0,0 +1,87 @@
+#ifndef MOCHIMOCHI_FEATURE_RANDOM_FOURIER_HPP_
+#define MOCHIMOCHI_FEATURE_RANDOM_FOURIER_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <random>
+
+namespace feature {
+
+  // Random Fourier features (Rahimi and Recht, Random Features for Large-Scale Kernel Machines)
+  // approximating the RBF kernel exp(-gamma * |x - y|^2) :
+  //   z(x) = sqrt(1 / D) [cos(W x), sin(W x)],  W_ij ~ N(0, 2 gamma)
+  // so that z(x)^T z(y) ~= k(x, y) and a linear learner on z behaves like a kernel machine.
+  // The projection is drawn from `seed`, so the same arguments always give the same map.
+  class RandomFourierFeatures {
+  private :
+    static constexpr std::size_t kBlock = 256;
+
+  private :
+    const std::size_t kInputDim;
+    const std::size_t kComponents;
+    const double kGamma;
+    const unsigned int kSeed;
+    const double kScale;
+
+  private :
+    Eigen::MatrixXd _projection;
+
+  public :
+    RandomFourierFeatures(const std::size_t input_dim, const std::size_t components, const double gamma,
+                          const unsigned int seed = 1)
+      : kInputDim(input_dim),
+        kComponents(components),
+        kGamma(gamma),
+        kSeed(seed),
+        kScale(std::sqrt(1.0 / components)),
+        _projection(components, input_dim) {
+      assert(components > 0);
+      assert(gamma > 0);
+      std::mt19937 engine(seed);
+      std::normal_distribution<double> normal(0.0, std::sqrt(2.0 * gamma));
+      for (std::size_t j = 0; j < input_dim; ++j) {
+        for (std::size_t i = 0; i < components; ++i) { _projection(i, j) = normal(engine); }
+      }
+    }
+
+  public :
+
+    // writes into z, reusing its storage when it already has output_dim() entries
+    void transform(const Eigen::VectorXd& x, Eigen::VectorXd& z) const {
+      assert(static_cast<std::size_t>(x.size()) == kInputDim);
+      z.resize(2 * kComponents);
+      z.head(kComponents).noalias() = _projection * x;
+      // Eigen vectorizes sin / cos for float only : the phases go through a float
+      // block on the stack, the float rounding being far below the sampling noise of the map
+      Eigen::Array<float, kBlock, 1> phase, cosine, sine;
+      for (std::size_t begin = 0; begin < kComponents; begin += kBlock) {
+        const auto n = static_cast<Eigen::Index>(std::min(kBlock, kComponents - begin));
+        phase.head(n) = z.segment(begin, n).array().cast<float>();
+        cosine.head(n) = phase.head(n).cos();
+        sine.head(n) = phase.head(n).sin();
+        z.segment(begin, n) = kScale * cosine.head(n).cast<double>();
+        z.segment(kComponents + begin, n) = kScale * sine.head(n).cast<double>();
+      }
+    }
+
+    Eigen::VectorXd transform(const Eigen::VectorXd& x) const {
+      Eigen::VectorXd z;
+      transform(x, z);
+      return z;
+    }
+
+    std::size_t input_dim(void) const { return kInputDim; }
+
+    // dimension the learner has to be built with
+    std::size_t output_dim(void) const { return 2 * kComponents; }
+
+    double gamma(void) const { return kGamma; }
+
+    unsigned int seed(void) const { return kSeed; }
+  };
+
+};
+
+#endif //MOCHIMOCHI_FEATURE_RANDOM_FOURIER_HPP_
@@ -0,0 +1,7 @@
+#ifndef MOCHIMOCHI_FILTER_HPP_
+#define MOCHIMOCHI_FILTER_HPP_
+
+#include "./filter/count_min_sketch.hpp"
+#include "./filter/feature_admission.hpp"
+
+#endif //MOCHIMOCHI_FILTER_HPP_
@@ -0,0 +1,75 @@
+#ifndef MOCHIMOCHI_FILTER_COUNT_MIN_SKETCH_HPP_
+#define MOCHIMOCHI_FILTER_COUNT_MIN_SKETCH_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace filter {
+
+  // Count-Min sketch (Cormode and Muthukrishnan) with conservative update :
+  // only the smallest counters of a key are incremented, which keeps the
+  // overestimation of rare keys low.
+  class CountMinSketch {
+  private :
+    const std::size_t kWidth;
+    const std::size_t kDepth;
+
+  private :
+    std::vector<std::uint32_t> _counters;
+
+  private :
+    static std::uint64_t mix(std::uint64_t x) {
+      x += 0x9e3779b97f4a7c15ULL;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+      return x ^ (x >> 31);
+    }
+
+    std::size_t cell(const std::size_t row, const std::uint64_t key) const {
+      return row * kWidth + mix(key + row * 0x632be59bd9b4e019ULL) % kWidth;
+    }
+
+  public :
+    CountMinSketch(const std::size_t width, const std::size_t depth)
+      : kWidth(width),
+        kDepth(depth),
+        _counters(width * depth, 0) {
+      assert(width > 0);
+      assert(depth > 0);
+    }
+
+    // returns the estimated count after the increment
+    std::uint32_t add(const std::uint64_t key) {
+      const auto count = estimate(key);
+      if (count == std::numeric_limits<std::uint32_t>::max()) { return count; }
+      for (std::size_t row = 0; row < kDepth; ++row) {
+        auto& counter = _counters[cell(row, key)];
+        counter = std::max(counter, count + 1);
+      }
+      return count + 1;
+    }
+
+    std::uint32_t estimate(const std::uint64_t key) const {
+      auto count = std::numeric_limits<std::uint32_t>::max();
+      for (std::size_t row = 0; row < kDepth; ++row) {
+        count = std::min(count, _counters[cell(row, key)]);
+      }
+      return count;
+    }
+
+    // halves every counter so that old counts fade on an unbounded stream
+    void decay(void) {
+      for (auto& counter : _counters) { counter >>= 1; }
+    }
+
+    std::size_t memory_bytes(void) const {
+      return _counters.size() * sizeof(std::uint32_t);
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_FILTER_COUNT_MIN_SKETCH_HPP_
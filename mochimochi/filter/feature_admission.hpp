@@ -0,0 +1,191 @@
+#ifndef MOCHIMOCHI_FILTER_FEATURE_ADMISSION_HPP_
+#define MOCHIMOCHI_FILTER_FEATURE_ADMISSION_HPP_
+
+#include <Eigen/Dense>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include "./count_min_sketch.hpp"
+
+namespace filter {
+
+  // Admits a feature to the model only after it has been seen `threshold`
+  // times (estimated by a Count-Min sketch). With a budget, at most `budget`
+  // features are admitted at a time and the least recently seen one is
+  // evicted first. Features that are not admitted are zeroed before the
+  // example reaches the learner, so they neither change nor use its parameters.
+  // An evicted feature keeps its stale weight in the learner : it is unused while
+  // the feature stays out, and training resumes from it if the feature comes back.
+  class FeatureAdmission {
+  private :
+    const std::uint32_t kThreshold;
+    const std::size_t kBudget;
+    const std::uint64_t kDecayInterval;
+
+  private :
+    CountMinSketch _sketch;
+    std::list<std::size_t> _recency;
+    std::unordered_map<std::size_t, std::list<std::size_t>::iterator> _admitted;
+    std::uint64_t _examples;
+    std::uint64_t _filtered;
+    std::uint64_t _evicted;
+
+  public :
+    // budget = 0 : no limit, decay_interval = 0 : the counts never decay
+    FeatureAdmission(const std::uint32_t threshold, const std::size_t budget = 0,
+                     const std::size_t width = 1 << 20, const std::size_t depth = 4,
+                     const std::uint64_t decay_interval = 0)
+      : kThreshold(threshold),
+        kBudget(budget),
+        kDecayInterval(decay_interval),
+        _sketch(width, depth),
+        _examples(0),
+        _filtered(0),
+        _evicted(0) { }
+
+    // the index points into the recency list, so it is rebuilt for the copy
+    FeatureAdmission(const FeatureAdmission& other)
+      : kThreshold(other.kThreshold),
+        kBudget(other.kBudget),
+        kDecayInterval(other.kDecayInterval),
+        _sketch(other._sketch),
+        _recency(other._recency),
+        _examples(other._examples),
+        _filtered(other._filtered),
+        _evicted(other._evicted) {
+      for (auto it = _recency.begin(); it != _recency.end(); ++it) { _admitted.emplace(*it, it); }
+    }
+
+    // a moved list keeps its nodes, so the index stays valid
+    FeatureAdmission(FeatureAdmission&&) = default;
+
+    virtual ~FeatureAdmission() { }
+
+  private :
+
+    void touch(const std::size_t index) {
+      const auto it = _admitted.find(index);
+      if (it != _admitted.end()) {
+        _recency.splice(_recency.begin(), _recency, it->second);
+        return;
+      }
+      _recency.push_front(index);
+      _admitted.emplace(index, _recency.begin());
+    }
+
+    void evict(void) {
+      while (kBudget > 0 && _admitted.size() > kBudget) {
+        _admitted.erase(_recency.back());
+        _recency.pop_back();
+        ++_evicted;
+      }
+    }
+
+  public :
+
+    // counts the features of a training example and returns it restricted to the admitted features
+    Eigen::VectorXd observe(const Eigen::VectorXd& feature) {
+      ++_examples;
+      for (std::size_t i = 0; i < static_cast<std::size_t>(feature.size()); ++i) {
+        if (feature[i] == 0.0) { continue; }
+        if (admitted(i) || _sketch.add(i) >= kThreshold) {
+          touch(i);
+        }
+      }
+      evict();
+      if (kDecayInterval > 0 && _examples % kDecayInterval == 0) { _sketch.decay(); }
+
+      Eigen::VectorXd admitted_feature = feature;
+      for (std::size_t i = 0; i < static_cast<std::size_t>(feature.size()); ++i) {
+        if (feature[i] != 0.0 && !admitted(i)) {
+          admitted_feature[i] = 0.0;
+          ++_filtered;
+        }
+      }
+      return admitted_feature;
+    }
+
+    // restricts an example to the admitted features without counting it
+    Eigen::VectorXd mask(const Eigen::VectorXd& feature) const {
+      Eigen::VectorXd admitted_feature = feature;
+      for (std::size_t i = 0; i < static_cast<std::size_t>(feature.size()); ++i) {
+        if (feature[i] != 0.0 && !admitted(i)) { admitted_feature[i] = 0.0; }
+      }
+      return admitted_feature;
+    }
+
+    bool admitted(const std::size_t index) const {
+      return _admitted.count(index) > 0;
+    }
+
+    std::size_t size(void) const { return _admitted.size(); }
+
+    // feature occurrences dropped from training examples
+    std::uint64_t filtered(void) const { return _filtered; }
+
+    std::uint64_t evicted(void) const { return _evicted; }
+
+    std::size_t memory_bytes(void) const {
+      // sketch + (list node + hash node) per admitted feature, approximately
+      return _sketch.memory_bytes() + _admitted.size() * 8 * sizeof(void*);
+    }
+  };
+
+  // A learner behind a FeatureAdmission filter.
+  template <class Learner>
+  class Admitted {
+  private :
+    FeatureAdmission _admission;
+    Learner _learner;
+
+  public :
+    Admitted(FeatureAdmission admission, Learner learner)
+      : _admission(std::move(admission)),
+        _learner(std::move(learner)) { }
+
+    virtual ~Admitted() { }
+
+  public :
+
+    template <typename Label>
+    auto update(const Eigen::VectorXd& feature, const Label label) -> decltype(_learner.update(feature, label)) {
+      return _learner.update(_admission.observe(feature), label);
+    }
+
+    // the admission counts the example once, the learner `weight` times
+    template <typename Label>
+    auto update(const Eigen::VectorXd& feature, const Label label, const double weight)
+      -> decltype(_learner.update(feature, label, weight)) {
+      return _learner.update(_admission.observe(feature), label, weight);
+    }
+
+    auto predict(const Eigen::VectorXd& feature) const -> decltype(_learner.predict(feature)) {
+      return _learner.predict(_admission.mask(feature));
+    }
+
+    template <class L = Learner>
+    auto compute_margin(const Eigen::VectorXd& feature) const -> decltype(std::declval<const L&>().compute_margin(feature)) {
+      return _learner.compute_margin(_admission.mask(feature));
+    }
+
+    template <class L = Learner>
+    auto compute_scores(const Eigen::VectorXd& feature) const -> decltype(std::declval<const L&>().compute_scores(feature)) {
+      return _learner.compute_scores(_admission.mask(feature));
+    }
+
+    const FeatureAdmission& admission(void) const { return _admission; }
+
+    Learner& learner(void) { return _learner; }
+
+    const Learner& learner(void) const { return _learner; }
+  };
+
+  template <class Learner>
+  Admitted<Learner> make_admitted(FeatureAdmission admission, Learner learner) {
+    return Admitted<Learner>(std::move(admission), std::move(learner));
+  }
+
+};
+
+#endif //MOCHIMOCHI_FILTER_FEATURE_ADMISSION_HPP_
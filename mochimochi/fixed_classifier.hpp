@@ -0,0 +1,7 @@
+#ifndef MOCHIMOCHI_FIXED_CLASSIFIER_HPP_
+#define MOCHIMOCHI_FIXED_CLASSIFIER_HPP_
+
+#include "./classifier/fixed/arow.hpp"
+#include "./classifier/fixed/scw.hpp"
+
+#endif //MOCHIMOCHI_FIXED_CLASSIFIER_HPP_
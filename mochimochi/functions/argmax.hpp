@@ -0,0 +1,23 @@
+#ifndef MOCHIMOCHI_FUNCTIONS_ARGMAX_HPP_
+#define MOCHIMOCHI_FUNCTIONS_ARGMAX_HPP_
+
+#include <Eigen/Dense>
+
+namespace functions {
+  // Index of the column of parameters (dim x K) with the highest score for x,
+  // computed column by column so that no score vector is allocated.
+  inline std::size_t argmax_score(const Eigen::MatrixXd& parameters, const Eigen::VectorXd& x) {
+    std::size_t best = 0;
+    auto best_score = parameters.col(0).dot(x);
+    for (std::size_t k = 1; k < static_cast<std::size_t>(parameters.cols()); ++k) {
+      const auto score = parameters.col(k).dot(x);
+      if (score > best_score) {
+        best = k;
+        best_score = score;
+      }
+    }
+    return best;
+  }
+};
+
+#endif //MOCHIMOCHI_FUNCTIONS_ARGMAX_HPP_
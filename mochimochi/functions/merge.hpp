@@ -0,0 +1,67 @@
+#ifndef MOCHIMOCHI_FUNCTIONS_MERGE_HPP_
+#define MOCHIMOCHI_FUNCTIONS_MERGE_HPP_
+
+#include <Eigen/Dense>
+#include <boost/serialization/nvp.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace functions {
+  // warm_start / merge : a parameter of the other model has to match the learner
+  template <typename T>
+  inline void check_compatible(const std::string& name, const T expected, const T actual) {
+    if (expected == actual) { return; }
+    std::ostringstream oss;
+    oss << "Incompatible model : " << name << " is " << actual << " (expected " << expected << ")";
+    throw std::runtime_error(oss.str());
+  }
+
+  inline void check_readable(const std::string& filename) {
+    if (!std::ifstream(filename)) { throw std::runtime_error("Cannot open " + filename); }
+  }
+
+  // learners saved as one file per class (MPA, MAROW, ..., LabelTree) : <filename> holds the class count
+  inline void save_class_count(const std::string& filename, std::size_t n_class) {
+    std::ofstream ofs(filename);
+    assert(ofs);
+    boost::archive::text_oarchive oa(ofs);
+    oa << boost::serialization::make_nvp("class", n_class);
+  }
+
+  inline std::size_t load_class_count(const std::string& filename) {
+    check_readable(filename);
+    std::ifstream ifs(filename);
+    boost::archive::text_iarchive ia(ifs);
+    std::size_t n_class;
+    ia >> boost::serialization::make_nvp("class", n_class);
+    return n_class;
+  }
+
+  // Precision weighted merge of diagonal Gaussians N(means, covariances) (AROW, SCW, NHERD) :
+  // both models started from the N(0, I) prior, so the evidence of `other`,
+  // (precision - 1, precision * mean), scaled by weight, is added to the model.
+  template <class Matrix>
+  inline void merge_gaussians(Matrix& means, Matrix& covariances, const Matrix& other_means,
+                              const Matrix& other_covariances, const double weight) {
+    check_compatible("size", covariances.size(), other_covariances.size());
+    const auto precision = (covariances.array().inverse() +
+                            weight * (other_covariances.array().inverse() - 1.0)).eval();
+    means = ((means.array() / covariances.array() + weight * other_means.array() / other_covariances.array())
+             / precision).matrix();
+    covariances = precision.inverse().matrix();
+  }
+
+  // (1 - weight) * parameters + weight * other (PA, ADAM)
+  template <class Matrix>
+  inline void merge_average(Matrix& parameters, const Matrix& other, const double weight) {
+    check_compatible("size", parameters.size(), other.size());
+    parameters = (1.0 - weight) * parameters + weight * other;
+  }
+};
+
+#endif //MOCHIMOCHI_FUNCTIONS_MERGE_HPP_
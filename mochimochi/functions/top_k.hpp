@@ -0,0 +1,67 @@
+#ifndef MOCHIMOCHI_FUNCTIONS_TOP_K_HPP_
+#define MOCHIMOCHI_FUNCTIONS_TOP_K_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace functions {
+  // (label, score) pairs ordered from the highest score
+  using Ranking = std::vector<std::pair<std::size_t, double>>;
+
+  // Keeps the k highest scores pushed so far in a min-heap,
+  // so a score that cannot enter costs a single comparison.
+  class TopK {
+  private :
+    const std::size_t kK;
+
+  private :
+    Ranking _heap;
+
+  private :
+    static bool greater(const std::pair<std::size_t, double>& a, const std::pair<std::size_t, double>& b) {
+      return a.second > b.second;
+    }
+
+  public :
+    explicit TopK(const std::size_t k) : kK(k) {
+      assert(k > 0);
+      _heap.reserve(k);
+    }
+
+    void push(const std::size_t label, const double score) {
+      if (_heap.size() < kK) {
+        _heap.emplace_back(label, score);
+        std::push_heap(_heap.begin(), _heap.end(), greater);
+      } else if (score > _heap.front().second) {
+        std::pop_heap(_heap.begin(), _heap.end(), greater);
+        _heap.back() = std::make_pair(label, score);
+        std::push_heap(_heap.begin(), _heap.end(), greater);
+      }
+    }
+
+    bool full(void) const { return _heap.size() == kK; }
+
+    // lowest score kept, the one a new score has to beat once full()
+    double threshold(void) const { return _heap.front().second; }
+
+    Ranking sorted(void) const {
+      auto ranking = _heap;
+      std::sort_heap(ranking.begin(), ranking.end(), greater);
+      return ranking;
+    }
+  };
+
+  // labels are index + 1, as in the compute_scores of the multi-class learners
+  inline Ranking top_k(const Eigen::VectorXd& scores, const std::size_t k) {
+    TopK top(k);
+    for (std::size_t i = 0; i < static_cast<std::size_t>(scores.size()); ++i) {
+      top.push(i + 1, scores[i]);
+    }
+    return top.sorted();
+  }
+};
+
+#endif //MOCHIMOCHI_FUNCTIONS_TOP_K_HPP_
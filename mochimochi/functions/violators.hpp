@@ -0,0 +1,43 @@
+#ifndef MOCHIMOCHI_FUNCTIONS_VIOLATORS_HPP_
+#define MOCHIMOCHI_FUNCTIONS_VIOLATORS_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <vector>
+
+namespace functions {
+  // Writes the (at most top_k) wrong classes whose score is within margin
+  // of the correct class, ordered from the highest score, into violators
+  // (reusing its storage).
+  inline void find_violators(const Eigen::VectorXd& scores,
+                             const std::size_t correct,
+                             const std::size_t top_k,
+                             const double margin,
+                             std::vector<std::size_t>& violators) {
+    violators.clear();
+    for (std::size_t i = 0; i < static_cast<std::size_t>(scores.size()); ++i) {
+      if (i != correct && scores[correct] - scores[i] < margin) {
+        violators.push_back(i);
+      }
+    }
+
+    const auto by_score = [&](const std::size_t a, const std::size_t b) { return scores[a] > scores[b]; };
+    if (violators.size() > top_k) {
+      std::partial_sort(violators.begin(), violators.begin() + top_k, violators.end(), by_score);
+      violators.resize(top_k);
+    } else {
+      std::sort(violators.begin(), violators.end(), by_score);
+    }
+  }
+
+  inline std::vector<std::size_t> find_violators(const Eigen::VectorXd& scores,
+                                                 const std::size_t correct,
+                                                 const std::size_t top_k,
+                                                 const double margin = 1.0) {
+    std::vector<std::size_t> violators;
+    find_violators(scores, correct, top_k, margin, violators);
+    return violators;
+  }
+};
+
+#endif //MOCHIMOCHI_FUNCTIONS_VIOLATORS_HPP_
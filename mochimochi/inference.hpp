@@ -0,0 +1,8 @@
+#ifndef MOCHIMOCHI_INFERENCE_HPP_
+#define MOCHIMOCHI_INFERENCE_HPP_
+
+#include "./inference/frozen_model.hpp"
+#include "./inference/model_delta.hpp"
+#include "./inference/tracked.hpp"
+
+#endif //MOCHIMOCHI_INFERENCE_HPP_
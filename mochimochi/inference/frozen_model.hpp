@@ -0,0 +1,435 @@
+#ifndef MOCHIMOCHI_INFERENCE_FROZEN_MODEL_HPP_
+#define MOCHIMOCHI_INFERENCE_FROZEN_MODEL_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../functions/top_k.hpp"
+#include "../kernel/dot.hpp"
+#include "./model_delta.hpp"
+
+namespace inference {
+
+  namespace detail {
+    // Weight storage padded so that every class row starts on a cache line.
+    template <typename T>
+    struct Storage {
+      static constexpr std::size_t kAlign = 64 / sizeof(T);
+
+      static std::size_t stride(const std::size_t dim) {
+        return (dim + kAlign - 1) / kAlign * kAlign;
+      }
+    };
+
+    // The parameters of a learner : get_means() for the confidence weighted
+    // learners, get_weight() for the others. Multi-class learners return a
+    // dim x K matrix whose column (label - 1) belongs to each class.
+    template <class Learner>
+    auto parameters(const Learner& learner, int) -> decltype(learner.get_means()) {
+      return learner.get_means();
+    }
+
+    template <class Learner>
+    auto parameters(const Learner& learner, long) -> decltype(learner.get_weight()) {
+      return learner.get_weight();
+    }
+
+    constexpr char kMagic[8] = { 'M', 'O', 'C', 'H', 'I', 'F', 'R', 'Z' };
+    constexpr std::uint32_t kVersion = 1;
+
+    // file header : magic, uint32 version, uint32 width, uint64 dim, uint64 n_class
+    constexpr std::size_t kHeaderBytes = sizeof(kMagic) + 2 * sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+
+    struct Header {
+      std::uint32_t width;
+      std::uint64_t dim;
+      std::uint64_t n_class;
+    };
+
+    inline bool parse_header(const char* bytes, Header& header) {
+      std::uint32_t version;
+      const auto p = bytes + sizeof(kMagic);
+      std::memcpy(&version, p, sizeof(version));
+      std::memcpy(&header.width, p + 4, sizeof(header.width));
+      std::memcpy(&header.dim, p + 8, sizeof(header.dim));
+      std::memcpy(&header.n_class, p + 16, sizeof(header.n_class));
+      return std::equal(bytes, bytes + sizeof(kMagic), kMagic) && version == kVersion && header.dim > 0 && header.n_class > 0;
+    }
+  };
+
+  // Immutable, inference-only copy of a trained linear model.
+  // T = float keeps the weights in float32, T = std::int8_t quantizes them
+  // per block of kBlock weights with one float scale per block.
+  // A model with one class behaves as a binary classifier (predict -> +1 / -1),
+  // otherwise predict returns the label (1 .. K) with the highest score.
+  template <typename T>
+  class FrozenModel {
+    static_assert(std::is_same<T, float>::value || std::is_same<T, std::int8_t>::value,
+                  "FrozenModel supports float and int8_t weights.");
+
+  public :
+    static constexpr std::size_t kBlock = 32;
+
+  private :
+    // weights built by compile or load, only modified by apply on a model owning them alone
+    struct Buffers {
+      std::vector<T, Eigen::aligned_allocator<T>> weight;
+      std::vector<float> scales;
+    };
+
+  private :
+    std::size_t _dim;
+    std::size_t _class;
+    std::size_t _stride;
+    // owner of the weights (heap buffers or a mapped file), shared by the copies of the model
+    std::shared_ptr<const void> _memory;
+    const T* _weight;
+    const float* _scales;
+    // the heap buffers behind _memory (nullptr for a mapped model)
+    Buffers* _owned;
+    std::vector<double> _norms;
+    std::vector<std::size_t> _order;
+
+  private :
+    FrozenModel(const std::size_t dim, const std::size_t n_class, std::shared_ptr<const void> memory,
+                const T* weight, const float* scales, Buffers* owned = nullptr)
+      : _dim(dim),
+        _class(n_class),
+        _stride(detail::Storage<T>::stride(dim)),
+        _memory(std::move(memory)),
+        _weight(weight),
+        _scales(scales),
+        _owned(owned) { }
+
+    static std::size_t n_blocks(const std::size_t dim) {
+      return (dim + kBlock - 1) / kBlock;
+    }
+
+    static std::size_t weight_size(const std::size_t dim, const std::size_t n_class) {
+      return detail::Storage<T>::stride(dim) * n_class;
+    }
+
+    static std::size_t scale_size(const std::size_t dim, const std::size_t n_class) {
+      return std::is_same<T, std::int8_t>::value ? n_blocks(dim) * n_class : 0;
+    }
+
+    static std::shared_ptr<Buffers> allocate(const std::size_t dim, const std::size_t n_class) {
+      auto buffers = std::make_shared<Buffers>();
+      buffers->weight.assign(weight_size(dim, n_class), T(0));
+      buffers->scales.assign(scale_size(dim, n_class), 0.0f);
+      return buffers;
+    }
+
+    static FrozenModel own(const std::size_t dim, const std::size_t n_class, const std::shared_ptr<Buffers>& buffers) {
+      return FrozenModel(dim, n_class, buffers, buffers->weight.data(), buffers->scales.data(), buffers.get());
+    }
+
+    void store(Buffers& buffers, const std::size_t k, const double* w, std::true_type /* float */) const {
+      std::transform(w, w + _dim, buffers.weight.data() + k * _stride,
+                     [](const double v) { return static_cast<float>(v); });
+    }
+
+    void store(Buffers& buffers, const std::size_t k, const double* w, std::false_type /* int8 */) const {
+      for (std::size_t b = 0; b < n_blocks(_dim); ++b) { store_block(buffers, k, b, w + b * kBlock); }
+    }
+
+    // w : the weights of block b
+    void store_block(Buffers& buffers, const std::size_t k, const std::size_t b, const double* w) const {
+      const auto begin = b * kBlock;
+      const auto end = std::min(begin + kBlock, _dim);
+      auto max_abs = 0.0;
+      for (auto i = begin; i < end; ++i) { max_abs = std::max(max_abs, std::abs(w[i - begin])); }
+
+      const auto scale = max_abs / 127.0;
+      buffers.scales[k * n_blocks(_dim) + b] = static_cast<float>(scale);
+      for (auto i = begin; i < end; ++i) {
+        buffers.weight[k * _stride + i] = (scale > 0.0) ? static_cast<std::int8_t>(std::lround(w[i - begin] / scale)) : 0;
+      }
+    }
+
+    // sets one weight and returns the change of the squared norm of class k
+    double assign(Buffers& buffers, const std::size_t k, const std::size_t i, const double value,
+                  std::true_type /* float */) {
+      auto& w = buffers.weight[k * _stride + i];
+      const auto before = static_cast<double>(w) * w;
+      w = static_cast<float>(value);
+      return static_cast<double>(w) * w - before;
+    }
+
+    // int8 : the block of the weight is quantized again around the new value
+    double assign(Buffers& buffers, const std::size_t k, const std::size_t i, const double value,
+                  std::false_type /* int8 */) {
+      const auto b = i / kBlock;
+      const auto begin = b * kBlock;
+      const auto end = std::min(begin + kBlock, _dim);
+      const auto block_norm = [&]() {
+        auto sum = 0.0;
+        for (auto j = begin; j < end; ++j) { sum += buffers.weight[k * _stride + j] * buffers.weight[k * _stride + j]; }
+        const double scale = buffers.scales[k * n_blocks(_dim) + b];
+        return scale * scale * sum;
+      };
+
+      const auto before = block_norm();
+      double w[kBlock];
+      for (auto j = begin; j < end; ++j) {
+        w[j - begin] = static_cast<double>(buffers.scales[k * n_blocks(_dim) + b]) * buffers.weight[k * _stride + j];
+      }
+      w[i - begin] = value;
+      store_block(buffers, k, b, w);
+      return block_norm() - before;
+    }
+
+    double norm(const std::size_t k, std::true_type /* float */) const {
+      const auto w = _weight + k * _stride;
+      auto sum = 0.0;
+      for (std::size_t i = 0; i < _dim; ++i) { sum += static_cast<double>(w[i]) * w[i]; }
+      return std::sqrt(sum);
+    }
+
+    double norm(const std::size_t k, std::false_type /* int8 */) const {
+      const auto blocks = n_blocks(_dim);
+      auto sum = 0.0;
+      for (std::size_t b = 0; b < blocks; ++b) {
+        auto partial = 0.0;
+        for (auto i = b * kBlock; i < std::min((b + 1) * kBlock, _dim); ++i) {
+          partial += _weight[k * _stride + i] * _weight[k * _stride + i];
+        }
+        sum += static_cast<double>(_scales[k * blocks + b]) * _scales[k * blocks + b] * partial;
+      }
+      return std::sqrt(sum);
+    }
+
+    // class norms and the classes ordered by decreasing norm, for predict_topk
+    void index(void) {
+      _norms.resize(_class);
+      _order.resize(_class);
+      for (std::size_t k = 0; k < _class; ++k) {
+        _norms[k] = norm(k, std::is_same<T, float>());
+        _order[k] = k;
+      }
+      std::sort(_order.begin(), _order.end(), [&](const std::size_t a, const std::size_t b) { return _norms[a] > _norms[b]; });
+    }
+
+    double dot(const std::size_t k, const double* x, std::true_type /* float */) const {
+      return kernel::dot(_weight + k * _stride, x, _dim);
+    }
+
+    double dot(const std::size_t k, const double* x, std::false_type /* int8 */) const {
+      return kernel::dot(_weight + k * _stride, _scales + k * n_blocks(_dim), x, _dim, kBlock);
+    }
+
+  public :
+    // parameters : dim x K matrix (or a vector for a binary classifier)
+    template <typename Derived>
+    static FrozenModel compile(const Eigen::MatrixBase<Derived>& parameters) {
+      const Eigen::MatrixXd w = parameters;
+      const auto buffers = allocate(w.rows(), w.cols());
+      auto model = own(w.rows(), w.cols(), buffers);
+      for (std::size_t k = 0; k < model._class; ++k) {
+        model.store(*buffers, k, w.col(k).data(), std::is_same<T, float>());
+      }
+      model.index();
+      return model;
+    }
+
+    static FrozenModel load(const std::string& filename) {
+      std::ifstream ifs(filename, std::ios::binary);
+      if (!ifs) { throw std::runtime_error("Cannot open the frozen model : " + filename); }
+
+      char bytes[detail::kHeaderBytes];
+      detail::Header header;
+      ifs.read(bytes, sizeof(bytes));
+      if (!ifs || !detail::parse_header(bytes, header) || header.width != sizeof(T)) {
+        throw std::runtime_error("Invalid frozen model : " + filename);
+      }
+
+      const auto buffers = allocate(header.dim, header.n_class);
+      ifs.read(reinterpret_cast<char*>(buffers->weight.data()), buffers->weight.size() * sizeof(T));
+      ifs.read(reinterpret_cast<char*>(buffers->scales.data()), buffers->scales.size() * sizeof(float));
+      if (!ifs) { throw std::runtime_error("Truncated frozen model : " + filename); }
+      auto model = own(header.dim, header.n_class, buffers);
+      model.index();
+      return model;
+    }
+
+    // Model over the bytes of a saved model (e.g. a mapped file) without copying the weights.
+    // memory keeps the bytes alive for the model and its copies.
+    static FrozenModel map(std::shared_ptr<const void> memory, const char* bytes, const std::size_t size) {
+      detail::Header header;
+      if (size < detail::kHeaderBytes || !detail::parse_header(bytes, header) || header.width != sizeof(T)) {
+        throw std::runtime_error("Invalid frozen model");
+      }
+      const auto weight_bytes = weight_size(header.dim, header.n_class) * sizeof(T);
+      const auto scale_bytes = scale_size(header.dim, header.n_class) * sizeof(float);
+      if (size < detail::kHeaderBytes + weight_bytes + scale_bytes) {
+        throw std::runtime_error("Truncated frozen model");
+      }
+
+      const auto weight = reinterpret_cast<const T*>(bytes + detail::kHeaderBytes);
+      const auto scales = reinterpret_cast<const float*>(bytes + detail::kHeaderBytes + weight_bytes);
+      FrozenModel model(header.dim, header.n_class, std::move(memory), weight, scales);
+      model.index();
+      return model;
+    }
+
+    // Applies a delta of the learner this model was compiled from (inference::Tracked).
+    // The weights are patched in place when this model is their only owner, otherwise
+    // (copies, mapped files) the model first takes a private copy, so the other
+    // holders never see a change. Not to be called while the model is in use.
+    void apply(const ModelDelta& delta) {
+      if (delta.dimension() != _dim || delta.n_class() != _class) {
+        throw std::runtime_error("Model delta does not fit the frozen model");
+      }
+      if (_owned == nullptr || _memory.use_count() > 1) {
+        const auto buffers = allocate(_dim, _class);
+        std::copy(_weight, _weight + buffers->weight.size(), buffers->weight.begin());
+        std::copy(_scales, _scales + buffers->scales.size(), buffers->scales.begin());
+        _memory = buffers;
+        _weight = buffers->weight.data();
+        _scales = buffers->scales.data();
+        _owned = buffers.get();
+      }
+
+      std::vector<double> squared(_class);
+      for (std::size_t k = 0; k < _class; ++k) { squared[k] = _norms[k] * _norms[k]; }
+      for (std::size_t e = 0; e < delta.size(); ++e) {
+        for (std::size_t k = 0; k < _class; ++k) {
+          squared[k] += assign(*_owned, k, delta.index(e), delta.value(e, k), std::is_same<T, float>());
+        }
+      }
+      for (std::size_t k = 0; k < _class; ++k) { _norms[k] = std::sqrt(std::max(0.0, squared[k])); }
+      std::sort(_order.begin(), _order.end(), [&](const std::size_t a, const std::size_t b) { return _norms[a] > _norms[b]; });
+    }
+
+    void save(const std::string& filename) const {
+      std::ofstream ofs(filename, std::ios::binary);
+      if (!ofs) { throw std::runtime_error("Cannot open the frozen model : " + filename); }
+
+      const std::uint32_t version = detail::kVersion;
+      const std::uint32_t width = sizeof(T);
+      const std::uint64_t dim = _dim;
+      const std::uint64_t n_class = _class;
+      ofs.write(detail::kMagic, sizeof(detail::kMagic));
+      ofs.write(reinterpret_cast<const char*>(&version), sizeof(version));
+      ofs.write(reinterpret_cast<const char*>(&width), sizeof(width));
+      ofs.write(reinterpret_cast<const char*>(&dim), sizeof(dim));
+      ofs.write(reinterpret_cast<const char*>(&n_class), sizeof(n_class));
+      ofs.write(reinterpret_cast<const char*>(_weight), weight_size(_dim, _class) * sizeof(T));
+      ofs.write(reinterpret_cast<const char*>(_scales), scale_size(_dim, _class) * sizeof(float));
+    }
+
+    double compute_score(const Eigen::VectorXd& x, const std::size_t label) const {
+      assert(static_cast<std::size_t>(x.size()) == _dim);
+      const auto k = (_class == 1) ? 0 : label - 1;
+      return dot(k, x.data(), std::is_same<T, float>());
+    }
+
+    double compute_margin(const Eigen::VectorXd& x) const {
+      return compute_score(x, 1);
+    }
+
+    int predict(const Eigen::VectorXd& x) const {
+      if (_class == 1) { return compute_margin(x) > 0.0 ? 1 : -1; }
+
+      std::size_t best = 1;
+      auto best_score = compute_score(x, 1);
+      for (std::size_t label = 2; label <= _class; ++label) {
+        const auto score = compute_score(x, label);
+        if (score > best_score) {
+          best = label;
+          best_score = score;
+        }
+      }
+      return static_cast<int>(best);
+    }
+
+    // The k best labels (multi-class models only) with their scores, from the highest.
+    // Classes are visited by decreasing weight norm and the scan stops as soon as
+    // |w_k| |x|, an upper bound of the score (Cauchy-Schwarz), cannot beat the k-th best score.
+    functions::Ranking predict_topk(const Eigen::VectorXd& x, const std::size_t k) const {
+      assert(_class > 1);
+      assert(static_cast<std::size_t>(x.size()) == _dim);
+      const auto x_norm = x.norm();
+      functions::TopK top(k);
+      for (const auto c : _order) {
+        if (top.full() && _norms[c] * x_norm <= top.threshold()) { break; }
+        top.push(c + 1, dot(c, x.data(), std::is_same<T, float>()));
+      }
+      return top.sorted();
+    }
+
+    // scores of a batch, column b holding the scores of xs[b] (one row per class).
+    // The loop runs class by class so that each weight row stays in cache for the whole batch.
+    Eigen::MatrixXd compute_scores(const std::vector<Eigen::VectorXd>& xs) const {
+      Eigen::MatrixXd scores(_class, xs.size());
+      for (std::size_t k = 0; k < _class; ++k) {
+        for (std::size_t b = 0; b < xs.size(); ++b) {
+          assert(static_cast<std::size_t>(xs[b].size()) == _dim);
+          scores(k, b) = dot(k, xs[b].data(), std::is_same<T, float>());
+        }
+      }
+      return scores;
+    }
+
+    // label for one column of compute_scores
+    int predict_from_scores(const Eigen::VectorXd& scores) const {
+      if (_class == 1) { return scores[0] > 0.0 ? 1 : -1; }
+      Eigen::VectorXd::Index best;
+      scores.maxCoeff(&best);
+      return static_cast<int>(best) + 1;
+    }
+
+    std::size_t dimension(void) const { return _dim; }
+
+    std::size_t n_class(void) const { return _class; }
+
+    std::size_t memory_bytes(void) const {
+      return weight_size(_dim, _class) * sizeof(T) + scale_size(_dim, _class) * sizeof(float);
+    }
+  };
+
+  template <typename T, class Learner>
+  FrozenModel<T> freeze(const Learner& learner) {
+    return FrozenModel<T>::compile(detail::parameters(learner, 0));
+  }
+
+  struct AccuracyReport {
+    std::size_t total;
+    std::size_t agree;
+    double max_score_error;
+
+    double agreement(void) const {
+      return total == 0 ? 1.0 : static_cast<double>(agree) / total;
+    }
+  };
+
+  // Compares the frozen model against the learner it was compiled from :
+  // the rate of identical predictions and the largest absolute score error.
+  template <typename T, class Learner>
+  AccuracyReport check_accuracy(const Learner& learner, const FrozenModel<T>& frozen,
+                                const std::vector<Eigen::VectorXd>& samples) {
+    const Eigen::MatrixXd parameters = detail::parameters(learner, 0);
+    AccuracyReport report = { 0, 0, 0.0 };
+    for (const auto& x : samples) {
+      ++report.total;
+      if (static_cast<int>(learner.predict(x)) == frozen.predict(x)) { ++report.agree; }
+      for (std::size_t k = 0; k < frozen.n_class(); ++k) {
+        const auto error = std::abs(parameters.col(k).dot(x) - frozen.compute_score(x, k + 1));
+        report.max_score_error = std::max(report.max_score_error, error);
+      }
+    }
+    return report;
+  }
+
+};
+
+#endif //MOCHIMOCHI_INFERENCE_FROZEN_MODEL_HPP_
@@ -0,0 +1,137 @@
+#ifndef MOCHIMOCHI_INFERENCE_MODEL_DELTA_HPP_
+#define MOCHIMOCHI_INFERENCE_MODEL_DELTA_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace inference {
+
+  namespace detail {
+    constexpr char kDeltaMagic[8] = { 'M', 'O', 'C', 'H', 'I', 'D', 'L', 'T' };
+    constexpr std::uint32_t kDeltaVersion = 1;
+  };
+
+  // New values of the features changed since the previous delta : for every
+  // feature index (0 based), the weights of all the classes (one for a binary
+  // model). The values are absolute, so applying a delta twice is harmless,
+  // but the deltas have to be applied in sequence order after the full model
+  // they follow.
+  //
+  // file : magic, uint32 version, uint32 reserved, uint64 sequence, uint64 dim,
+  //        uint64 n_class, uint64 count, count x uint32 index, count x n_class float32
+  class ModelDelta {
+  private :
+    std::uint64_t _sequence;
+    std::uint64_t _dim;
+    std::uint64_t _class;
+    std::vector<std::uint32_t> _indices;
+    std::vector<float> _values;
+
+  public :
+    ModelDelta(const std::uint64_t sequence, const std::uint64_t dim, const std::uint64_t n_class)
+      : _sequence(sequence),
+        _dim(dim),
+        _class(n_class) {
+      if (dim > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Model delta : dimension too large");
+      }
+    }
+
+  public :
+
+    // values : the n_class weights of the feature
+    template <typename Derived>
+    void add(const std::size_t index, const Eigen::MatrixBase<Derived>& values) {
+      if (index >= _dim || static_cast<std::uint64_t>(values.size()) != _class) {
+        throw std::runtime_error("Model delta : invalid entry");
+      }
+      _indices.push_back(static_cast<std::uint32_t>(index));
+      for (Eigen::Index k = 0; k < values.size(); ++k) { _values.push_back(static_cast<float>(values(k))); }
+    }
+
+    std::uint64_t sequence(void) const { return _sequence; }
+
+    std::size_t dimension(void) const { return _dim; }
+
+    std::size_t n_class(void) const { return _class; }
+
+    std::size_t size(void) const { return _indices.size(); }
+
+    std::size_t index(const std::size_t entry) const { return _indices[entry]; }
+
+    // the weight of class k (0 based) in an entry
+    float value(const std::size_t entry, const std::size_t k) const { return _values[entry * _class + k]; }
+
+    std::size_t bytes(void) const {
+      return sizeof(detail::kDeltaMagic) + 2 * sizeof(std::uint32_t) + 4 * sizeof(std::uint64_t)
+        + _indices.size() * sizeof(std::uint32_t) + _values.size() * sizeof(float);
+    }
+
+    void save(std::ostream& os) const {
+      const std::uint32_t version = detail::kDeltaVersion;
+      const std::uint32_t reserved = 0;
+      const std::uint64_t count = _indices.size();
+      os.write(detail::kDeltaMagic, sizeof(detail::kDeltaMagic));
+      os.write(reinterpret_cast<const char*>(&version), sizeof(version));
+      os.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+      os.write(reinterpret_cast<const char*>(&_sequence), sizeof(_sequence));
+      os.write(reinterpret_cast<const char*>(&_dim), sizeof(_dim));
+      os.write(reinterpret_cast<const char*>(&_class), sizeof(_class));
+      os.write(reinterpret_cast<const char*>(&count), sizeof(count));
+      os.write(reinterpret_cast<const char*>(_indices.data()), _indices.size() * sizeof(std::uint32_t));
+      os.write(reinterpret_cast<const char*>(_values.data()), _values.size() * sizeof(float));
+    }
+
+    void save(const std::string& filename) const {
+      std::ofstream ofs(filename, std::ios::binary);
+      if (!ofs) { throw std::runtime_error("Cannot open the model delta : " + filename); }
+      save(ofs);
+    }
+
+    static ModelDelta load(std::istream& is) {
+      char magic[sizeof(detail::kDeltaMagic)];
+      std::uint32_t version, reserved;
+      std::uint64_t sequence, dim, n_class, count;
+      is.read(magic, sizeof(magic));
+      is.read(reinterpret_cast<char*>(&version), sizeof(version));
+      is.read(reinterpret_cast<char*>(&reserved), sizeof(reserved));
+      is.read(reinterpret_cast<char*>(&sequence), sizeof(sequence));
+      is.read(reinterpret_cast<char*>(&dim), sizeof(dim));
+      is.read(reinterpret_cast<char*>(&n_class), sizeof(n_class));
+      is.read(reinterpret_cast<char*>(&count), sizeof(count));
+      if (!is || !std::equal(magic, magic + sizeof(magic), detail::kDeltaMagic) || version != detail::kDeltaVersion ||
+          count > dim) {
+        throw std::runtime_error("Invalid model delta");
+      }
+
+      ModelDelta delta(sequence, dim, n_class);
+      delta._indices.resize(count);
+      delta._values.resize(count * n_class);
+      is.read(reinterpret_cast<char*>(delta._indices.data()), count * sizeof(std::uint32_t));
+      is.read(reinterpret_cast<char*>(delta._values.data()), count * n_class * sizeof(float));
+      if (!is) { throw std::runtime_error("Truncated model delta"); }
+      for (const auto i : delta._indices) {
+        if (i >= dim) { throw std::runtime_error("Invalid model delta"); }
+      }
+      return delta;
+    }
+
+    static ModelDelta load(const std::string& filename) {
+      std::ifstream ifs(filename, std::ios::binary);
+      if (!ifs) { throw std::runtime_error("Cannot open the model delta : " + filename); }
+      return load(ifs);
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_INFERENCE_MODEL_DELTA_HPP_
@@ -0,0 +1,140 @@
+#ifndef MOCHIMOCHI_INFERENCE_TRACKED_HPP_
+#define MOCHIMOCHI_INFERENCE_TRACKED_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "./frozen_model.hpp"
+#include "./model_delta.hpp"
+
+namespace inference {
+
+  namespace detail {
+    // learners whose update returns nothing are assumed to have changed
+    template <class Update>
+    auto changed(Update&& update, int) -> decltype(static_cast<bool>(update())) {
+      return update();
+    }
+
+    template <class Update>
+    bool changed(Update&& update, long) {
+      update();
+      return true;
+    }
+  };
+
+  // A learner that remembers the features its updates changed since the last
+  // export_delta, which returns their new values (get_means / get_weight) and starts
+  // a new checkpoint. The confidence weighted and PA updates only change the features
+  // present in the example. ADAM (momentum) and ADAGRAD_RDA (timestep) also move weights
+  // outside the example and tell which ones with moved(index), scanned after each update.
+  // The averaged learners move every feature at each step and should be shipped whole instead.
+  template <class Learner>
+  class Tracked {
+  private :
+    Learner _learner;
+    std::vector<std::uint8_t> _dirty;
+    std::vector<std::size_t> _changed;
+    std::uint64_t _sequence;
+
+  private :
+    void mark(const std::size_t i) {
+      if (_dirty[i]) { return; }
+      _dirty[i] = 1;
+      _changed.push_back(i);
+    }
+
+    template <class L = Learner>
+    auto mark(const Eigen::VectorXd&, int) -> decltype(std::declval<const L&>().moved(std::size_t()), void()) {
+      for (std::size_t i = 0; i < _dirty.size(); ++i) {
+        if (_learner.moved(i)) { mark(i); }
+      }
+    }
+
+    void mark(const Eigen::VectorXd& feature, long) {
+      for (std::size_t i = 0; i < static_cast<std::size_t>(feature.size()); ++i) {
+        if (feature[i] != 0.0) { mark(i); }
+      }
+    }
+
+  public :
+    Tracked(Learner learner, const std::size_t dim)
+      : _learner(std::move(learner)),
+        _dirty(dim, 0),
+        _sequence(0) { }
+
+    virtual ~Tracked() { }
+
+  public :
+
+    template <typename Label>
+    bool update(const Eigen::VectorXd& feature, const Label label) {
+      const auto updated = detail::changed([&]() { return _learner.update(feature, label); }, 0);
+      if (updated) { mark(feature, 0); }
+      return updated;
+    }
+
+    template <typename Label>
+    bool update(const Eigen::VectorXd& feature, const Label label, const double weight) {
+      const auto updated = detail::changed([&]() { return _learner.update(feature, label, weight); }, 0);
+      if (updated) { mark(feature, 0); }
+      return updated;
+    }
+
+    auto predict(const Eigen::VectorXd& feature) const -> decltype(_learner.predict(feature)) {
+      return _learner.predict(feature);
+    }
+
+    template <class L = Learner>
+    auto compute_margin(const Eigen::VectorXd& feature) const -> decltype(std::declval<const L&>().compute_margin(feature)) {
+      return _learner.compute_margin(feature);
+    }
+
+    template <class L = Learner>
+    auto compute_scores(const Eigen::VectorXd& feature) const -> decltype(std::declval<const L&>().compute_scores(feature)) {
+      return _learner.compute_scores(feature);
+    }
+
+    // after changing the learner directly (warm_start, merge, synchronize ...)
+    void mark_all(void) {
+      for (std::size_t i = 0; i < _dirty.size(); ++i) { mark(i); }
+    }
+
+    // starts a new checkpoint without exporting (e.g. right after shipping the full model)
+    void checkpoint(void) {
+      for (const auto i : _changed) { _dirty[i] = 0; }
+      _changed.clear();
+    }
+
+    ModelDelta export_delta(void) {
+      const Eigen::MatrixXd w = detail::parameters(_learner, 0);
+      if (static_cast<std::size_t>(w.rows()) != _dirty.size()) {
+        throw std::runtime_error("Model delta : dimension mismatch");
+      }
+      ModelDelta delta(++_sequence, w.rows(), w.cols());
+      std::sort(_changed.begin(), _changed.end());
+      for (const auto i : _changed) { delta.add(i, w.row(i)); }
+      checkpoint();
+      return delta;
+    }
+
+    std::size_t changed(void) const { return _changed.size(); }
+
+    std::uint64_t sequence(void) const { return _sequence; }
+
+    Learner& learner(void) { return _learner; }
+
+    const Learner& learner(void) const { return _learner; }
+  };
+
+  template <class Learner>
+  Tracked<Learner> make_tracked(Learner learner, const std::size_t dim) {
+    return Tracked<Learner>(std::move(learner), dim);
+  }
+
+};
+
+#endif //MOCHIMOCHI_INFERENCE_TRACKED_HPP_
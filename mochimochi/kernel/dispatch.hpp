@@ -0,0 +1,369 @@
+#ifndef MOCHIMOCHI_KERNEL_DISPATCH_HPP_
+#define MOCHIMOCHI_KERNEL_DISPATCH_HPP_
+
+#include <Eigen/Dense>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MOCHIMOCHI_KERNEL_X86 1
+#include <immintrin.h>
+#define MOCHIMOCHI_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+// Kernels of the hot per-feature loops, compiled for several instruction
+// sets and selected at startup from CPUID. The level can be forced with
+// kernel::set_isa or the MOCHIMOCHI_ISA environment variable
+// (scalar, sse2, avx2, avx512) ; a level the CPU lacks falls back to the best supported one.
+namespace kernel {
+
+  enum class Isa { kScalar = 0, kSSE2 = 1, kAVX2 = 2, kAVX512 = 3 };
+
+  inline const char* isa_name(const Isa isa) {
+    switch (isa) {
+    case Isa::kSSE2 : return "sse2";
+    case Isa::kAVX2 : return "avx2";
+    case Isa::kAVX512 : return "avx512";
+    default : return "scalar";
+    }
+  }
+
+  inline Isa parse_isa(const std::string& name) {
+    if (name == "scalar") { return Isa::kScalar; }
+    if (name == "sse2") { return Isa::kSSE2; }
+    if (name == "avx2") { return Isa::kAVX2; }
+    if (name == "avx512") { return Isa::kAVX512; }
+    throw std::invalid_argument("Unknown instruction set : " + name);
+  }
+
+  inline Isa detect_isa(void) {
+#ifdef MOCHIMOCHI_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) { return Isa::kAVX512; }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { return Isa::kAVX2; }
+    if (__builtin_cpu_supports("sse2")) { return Isa::kSSE2; }
+#endif
+    return Isa::kScalar;
+  }
+
+  namespace scalar {
+    inline double dot(const double* w, const double* x, const std::size_t n) {
+      auto result = 0.0;
+      for (std::size_t i = 0; i < n; ++i) { result += w[i] * x[i]; }
+      return result;
+    }
+
+    inline double confidence(const double* covariances, const double* x, const std::size_t n) {
+      auto result = 0.0;
+      for (std::size_t i = 0; i < n; ++i) { result += covariances[i] * x[i] * x[i]; }
+      return result;
+    }
+
+    inline void update(double* means, double* covariances, const double* x, const std::size_t n,
+                       const double alpha, const double beta) {
+      for (std::size_t i = 0; i < n; ++i) {
+        const auto v = covariances[i] * x[i];
+        means[i] += alpha * v;
+        covariances[i] -= beta * v * v;
+      }
+    }
+
+    // compact weights (inference::FrozenModel), accumulated in double
+    inline double dot_f32(const float* w, const double* x, const std::size_t n) {
+      auto result = 0.0;
+      for (std::size_t i = 0; i < n; ++i) { result += w[i] * x[i]; }
+      return result;
+    }
+
+    inline double dot_i8(const std::int8_t* q, const double* x, const std::size_t n) {
+      auto result = 0.0;
+      for (std::size_t i = 0; i < n; ++i) { result += q[i] * x[i]; }
+      return result;
+    }
+  };
+
+#ifdef MOCHIMOCHI_KERNEL_X86
+  namespace sse2 {
+    MOCHIMOCHI_TARGET("sse2")
+    inline double dot(const double* w, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m128d acc0 = _mm_setzero_pd();
+      __m128d acc1 = _mm_setzero_pd();
+      for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(w + i), _mm_loadu_pd(x + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(w + i + 2), _mm_loadu_pd(x + i + 2)));
+      }
+      alignas(16) double lanes[2];
+      _mm_store_pd(lanes, _mm_add_pd(acc0, acc1));
+      return lanes[0] + lanes[1] + scalar::dot(w + i, x + i, n - i);
+    }
+
+    MOCHIMOCHI_TARGET("sse2")
+    inline double confidence(const double* covariances, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m128d acc = _mm_setzero_pd();
+      for (; i + 2 <= n; i += 2) {
+        const __m128d x2 = _mm_loadu_pd(x + i);
+        acc = _mm_add_pd(acc, _mm_mul_pd(_mm_loadu_pd(covariances + i), _mm_mul_pd(x2, x2)));
+      }
+      alignas(16) double lanes[2];
+      _mm_store_pd(lanes, acc);
+      return lanes[0] + lanes[1] + scalar::confidence(covariances + i, x + i, n - i);
+    }
+
+    MOCHIMOCHI_TARGET("sse2")
+    inline void update(double* means, double* covariances, const double* x, const std::size_t n,
+                       const double alpha, const double beta) {
+      std::size_t i = 0;
+      const __m128d a = _mm_set1_pd(alpha);
+      const __m128d b = _mm_set1_pd(beta);
+      for (; i + 2 <= n; i += 2) {
+        const __m128d c = _mm_loadu_pd(covariances + i);
+        const __m128d v = _mm_mul_pd(c, _mm_loadu_pd(x + i));
+        _mm_storeu_pd(means + i, _mm_add_pd(_mm_loadu_pd(means + i), _mm_mul_pd(a, v)));
+        _mm_storeu_pd(covariances + i, _mm_sub_pd(c, _mm_mul_pd(b, _mm_mul_pd(v, v))));
+      }
+      scalar::update(means + i, covariances + i, x + i, n - i, alpha, beta);
+    }
+
+    MOCHIMOCHI_TARGET("sse2")
+    inline double dot_f32(const float* w, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m128d acc0 = _mm_setzero_pd();
+      __m128d acc1 = _mm_setzero_pd();
+      for (; i + 4 <= n; i += 4) {
+        const __m128 w4 = _mm_loadu_ps(w + i);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_cvtps_pd(w4), _mm_loadu_pd(x + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(w4, w4)), _mm_loadu_pd(x + i + 2)));
+      }
+      alignas(16) double lanes[2];
+      _mm_store_pd(lanes, _mm_add_pd(acc0, acc1));
+      return lanes[0] + lanes[1] + scalar::dot_f32(w + i, x + i, n - i);
+    }
+
+    // SSE2 has no sign extension of bytes : each byte is repeated up to the top of its lane, then shifted down
+    MOCHIMOCHI_TARGET("sse2")
+    inline double dot_i8(const std::int8_t* q, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m128d acc0 = _mm_setzero_pd();
+      __m128d acc1 = _mm_setzero_pd();
+      for (; i + 4 <= n; i += 4) {
+        std::int32_t packed;
+        std::memcpy(&packed, q + i, sizeof(packed));
+        const __m128i bytes = _mm_cvtsi32_si128(packed);
+        const __m128i words = _mm_unpacklo_epi8(bytes, bytes);
+        const __m128i q4 = _mm_srai_epi32(_mm_unpacklo_epi16(words, words), 24);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_cvtepi32_pd(q4), _mm_loadu_pd(x + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(q4, 8)), _mm_loadu_pd(x + i + 2)));
+      }
+      alignas(16) double lanes[2];
+      _mm_store_pd(lanes, _mm_add_pd(acc0, acc1));
+      return lanes[0] + lanes[1] + scalar::dot_i8(q + i, x + i, n - i);
+    }
+  };
+
+  namespace avx2 {
+    MOCHIMOCHI_TARGET("avx2,fma")
+    inline double sum(const __m256d v) {
+      const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+      return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+
+    MOCHIMOCHI_TARGET("avx2,fma")
+    inline double dot(const double* w, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m256d acc0 = _mm256_setzero_pd();
+      __m256d acc1 = _mm256_setzero_pd();
+      for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(w + i), _mm256_loadu_pd(x + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(w + i + 4), _mm256_loadu_pd(x + i + 4), acc1);
+      }
+      return sum(_mm256_add_pd(acc0, acc1)) + scalar::dot(w + i, x + i, n - i);
+    }
+
+    MOCHIMOCHI_TARGET("avx2,fma")
+    inline double confidence(const double* covariances, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m256d acc = _mm256_setzero_pd();
+      for (; i + 4 <= n; i += 4) {
+        const __m256d x4 = _mm256_loadu_pd(x + i);
+        acc = _mm256_fmadd_pd(_mm256_loadu_pd(covariances + i), _mm256_mul_pd(x4, x4), acc);
+      }
+      return sum(acc) + scalar::confidence(covariances + i, x + i, n - i);
+    }
+
+    MOCHIMOCHI_TARGET("avx2,fma")
+    inline void update(double* means, double* covariances, const double* x, const std::size_t n,
+                       const double alpha, const double beta) {
+      std::size_t i = 0;
+      const __m256d a = _mm256_set1_pd(alpha);
+      const __m256d b = _mm256_set1_pd(-beta);
+      for (; i + 4 <= n; i += 4) {
+        const __m256d c = _mm256_loadu_pd(covariances + i);
+        const __m256d v = _mm256_mul_pd(c, _mm256_loadu_pd(x + i));
+        _mm256_storeu_pd(means + i, _mm256_fmadd_pd(a, v, _mm256_loadu_pd(means + i)));
+        _mm256_storeu_pd(covariances + i, _mm256_fmadd_pd(b, _mm256_mul_pd(v, v), c));
+      }
+      scalar::update(means + i, covariances + i, x + i, n - i, alpha, beta);
+    }
+
+    MOCHIMOCHI_TARGET("avx2,fma")
+    inline double dot_f32(const float* w, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m256d acc0 = _mm256_setzero_pd();
+      __m256d acc1 = _mm256_setzero_pd();
+      for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(w + i)), _mm256_loadu_pd(x + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(w + i + 4)), _mm256_loadu_pd(x + i + 4), acc1);
+      }
+      return sum(_mm256_add_pd(acc0, acc1)) + scalar::dot_f32(w + i, x + i, n - i);
+    }
+
+    MOCHIMOCHI_TARGET("avx2,fma")
+    inline double dot_i8(const std::int8_t* q, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m256d acc = _mm256_setzero_pd();
+      for (; i + 4 <= n; i += 4) {
+        std::int32_t packed;
+        std::memcpy(&packed, q + i, sizeof(packed));
+        const __m128i q4 = _mm_cvtepi8_epi32(_mm_cvtsi32_si128(packed));
+        acc = _mm256_fmadd_pd(_mm256_cvtepi32_pd(q4), _mm256_loadu_pd(x + i), acc);
+      }
+      return sum(acc) + scalar::dot_i8(q + i, x + i, n - i);
+    }
+  };
+
+  namespace avx512 {
+    // the 512 to 256 bit intrinsics trip -Wuninitialized in some GCC headers,
+    // so the lanes are summed from memory
+    MOCHIMOCHI_TARGET("avx512f")
+    inline double sum(const __m512d v) {
+      alignas(64) double lanes[8];
+      _mm512_store_pd(lanes, v);
+      return ((lanes[0] + lanes[4]) + (lanes[1] + lanes[5])) + ((lanes[2] + lanes[6]) + (lanes[3] + lanes[7]));
+    }
+
+    MOCHIMOCHI_TARGET("avx512f")
+    inline double dot(const double* w, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m512d acc0 = _mm512_setzero_pd();
+      __m512d acc1 = _mm512_setzero_pd();
+      for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(w + i), _mm512_loadu_pd(x + i), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(w + i + 8), _mm512_loadu_pd(x + i + 8), acc1);
+      }
+      return sum(_mm512_add_pd(acc0, acc1)) + scalar::dot(w + i, x + i, n - i);
+    }
+
+    MOCHIMOCHI_TARGET("avx512f")
+    inline double confidence(const double* covariances, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m512d acc = _mm512_setzero_pd();
+      for (; i + 8 <= n; i += 8) {
+        const __m512d x8 = _mm512_loadu_pd(x + i);
+        acc = _mm512_fmadd_pd(_mm512_loadu_pd(covariances + i), _mm512_mul_pd(x8, x8), acc);
+      }
+      return sum(acc) + scalar::confidence(covariances + i, x + i, n - i);
+    }
+
+    MOCHIMOCHI_TARGET("avx512f")
+    inline void update(double* means, double* covariances, const double* x, const std::size_t n,
+                       const double alpha, const double beta) {
+      std::size_t i = 0;
+      const __m512d a = _mm512_set1_pd(alpha);
+      const __m512d b = _mm512_set1_pd(-beta);
+      for (; i + 8 <= n; i += 8) {
+        const __m512d c = _mm512_loadu_pd(covariances + i);
+        const __m512d v = _mm512_mul_pd(c, _mm512_loadu_pd(x + i));
+        _mm512_storeu_pd(means + i, _mm512_fmadd_pd(a, v, _mm512_loadu_pd(means + i)));
+        _mm512_storeu_pd(covariances + i, _mm512_fmadd_pd(b, _mm512_mul_pd(v, v), c));
+      }
+      scalar::update(means + i, covariances + i, x + i, n - i, alpha, beta);
+    }
+
+    // the conversions go through their maskz forms, whose unmasked ones trip the same warning
+    MOCHIMOCHI_TARGET("avx512f")
+    inline double dot_f32(const float* w, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m512d acc0 = _mm512_setzero_pd();
+      __m512d acc1 = _mm512_setzero_pd();
+      for (; i + 16 <= n; i += 16) {
+        acc0 = _mm512_fmadd_pd(_mm512_maskz_cvtps_pd(0xFF, _mm256_loadu_ps(w + i)), _mm512_loadu_pd(x + i), acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_maskz_cvtps_pd(0xFF, _mm256_loadu_ps(w + i + 8)), _mm512_loadu_pd(x + i + 8), acc1);
+      }
+      return sum(_mm512_add_pd(acc0, acc1)) + scalar::dot_f32(w + i, x + i, n - i);
+    }
+
+    MOCHIMOCHI_TARGET("avx512f")
+    inline double dot_i8(const std::int8_t* q, const double* x, const std::size_t n) {
+      std::size_t i = 0;
+      __m512d acc = _mm512_setzero_pd();
+      for (; i + 8 <= n; i += 8) {
+        const __m256i q8 = _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(q + i)));
+        acc = _mm512_fmadd_pd(_mm512_maskz_cvtepi32_pd(0xFF, q8), _mm512_loadu_pd(x + i), acc);
+      }
+      return sum(acc) + scalar::dot_i8(q + i, x + i, n - i);
+    }
+  };
+#endif
+
+  struct Kernels {
+    Isa isa;
+    double (*dot)(const double*, const double*, std::size_t);
+    double (*confidence)(const double*, const double*, std::size_t);
+    void (*update)(double*, double*, const double*, std::size_t, double, double);
+    double (*dot_f32)(const float*, const double*, std::size_t);
+    double (*dot_i8)(const std::int8_t*, const double*, std::size_t);
+  };
+
+  namespace detail {
+    inline Kernels select(const Isa requested) {
+      const auto isa = static_cast<int>(requested) < static_cast<int>(detect_isa()) ? requested : detect_isa();
+      switch (isa) {
+#ifdef MOCHIMOCHI_KERNEL_X86
+      case Isa::kAVX512 : return { isa, avx512::dot, avx512::confidence, avx512::update, avx512::dot_f32, avx512::dot_i8 };
+      case Isa::kAVX2 : return { isa, avx2::dot, avx2::confidence, avx2::update, avx2::dot_f32, avx2::dot_i8 };
+      case Isa::kSSE2 : return { isa, sse2::dot, sse2::confidence, sse2::update, sse2::dot_f32, sse2::dot_i8 };
+#endif
+      default : return { Isa::kScalar, scalar::dot, scalar::confidence, scalar::update, scalar::dot_f32, scalar::dot_i8 };
+      }
+    }
+
+    inline Kernels& active(void) {
+      static Kernels kernels = select(std::getenv("MOCHIMOCHI_ISA") ? parse_isa(std::getenv("MOCHIMOCHI_ISA"))
+                                                                    : Isa::kAVX512);
+      return kernels;
+    }
+  };
+
+  inline const Kernels& kernels(void) { return detail::active(); }
+
+  // Not thread safe : call it before the learners are used.
+  inline Isa set_isa(const Isa isa) {
+    detail::active() = detail::select(isa);
+    return detail::active().isa;
+  }
+
+  inline Isa active_isa(void) { return detail::active().isa; }
+
+  inline double dot(const Eigen::VectorXd& w, const Eigen::VectorXd& x) {
+    return kernels().dot(w.data(), x.data(), x.size());
+  }
+
+  inline double confidence(const Eigen::VectorXd& covariances, const Eigen::VectorXd& x) {
+    return kernels().confidence(covariances.data(), x.data(), x.size());
+  }
+
+  // v = covariances * x ; means += alpha * v ; covariances -= beta * v * v
+  inline void update(Eigen::VectorXd& means, Eigen::VectorXd& covariances, const Eigen::VectorXd& x,
+                     const double alpha, const double beta) {
+    kernels().update(means.data(), covariances.data(), x.data(), x.size(), alpha, beta);
+  }
+
+};
+
+#endif //MOCHIMOCHI_KERNEL_DISPATCH_HPP_
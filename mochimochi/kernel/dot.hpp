@@ -0,0 +1,32 @@
+#ifndef MOCHIMOCHI_KERNEL_DOT_HPP_
+#define MOCHIMOCHI_KERNEL_DOT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include "./dispatch.hpp"
+
+// Dot products between compact (float32 / int8) weights and double features,
+// through the kernels selected at startup (kernel::kernels).
+// Accumulation is done in double so that the only error is the weight rounding.
+namespace kernel {
+
+  inline double dot(const float* w, const double* x, const std::size_t n) {
+    return kernels().dot_f32(w, x, n);
+  }
+
+  // q holds the weights quantized per block of `block` elements,
+  // the original weight being q[i] * scales[i / block].
+  inline double dot(const std::int8_t* q, const float* scales, const double* x,
+                    const std::size_t n, const std::size_t block) {
+    const auto& k = kernels();
+    double result = 0.0;
+    for (std::size_t begin = 0, b = 0; begin < n; begin += block, ++b) {
+      const auto end = (begin + block < n) ? begin + block : n;
+      result += scales[b] * k.dot_i8(q + begin, x + begin, end - begin);
+    }
+    return result;
+  }
+
+};
+
+#endif //MOCHIMOCHI_KERNEL_DOT_HPP_
@@ -5,5 +5,9 @@
 #include "./classifier/multi/mscw.hpp"
 #include "./classifier/multi/mnherd.hpp"
 #include "./classifier/multi/mpa.hpp"
+#include "./classifier/multi/mcpa.hpp"
+#include "./classifier/multi/mcarow.hpp"
+#include "./classifier/multi/mcscw.hpp"
+#include "./classifier/multi/label_tree.hpp"
 
 #endif //MOCHIMOCHI_MULTI_CLASSIFIER_HPP_
@@ -0,0 +1,9 @@
+#ifndef MOCHIMOCHI_PARALLEL_HPP_
+#define MOCHIMOCHI_PARALLEL_HPP_
+
+#include "./parallel/transport.hpp"
+#include "./parallel/allreduce.hpp"
+#include "./parallel/unix_socket_transport.hpp"
+#include "./parallel/shard_pool.hpp"
+
+#endif //MOCHIMOCHI_PARALLEL_HPP_
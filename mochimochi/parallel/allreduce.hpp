@@ -0,0 +1,61 @@
+#ifndef MOCHIMOCHI_PARALLEL_ALLREDUCE_HPP_
+#define MOCHIMOCHI_PARALLEL_ALLREDUCE_HPP_
+
+#include <Eigen/Dense>
+#include <cstddef>
+#include <vector>
+#include "./transport.hpp"
+
+namespace parallel {
+
+  // Sums vectors over all the workers of a transport along a binary tree
+  // (the parent of worker r is (r - 1) / 2) : the partial sums travel up to
+  // worker 0 and the total comes back down, so a call takes 2 log2(size)
+  // message latencies. Every worker has to make the same sequence of calls.
+  class Allreduce {
+  private :
+    Transport& _transport;
+    std::vector<double> _buffer;
+
+  public :
+    explicit Allreduce(Transport& transport) : _transport(transport) { }
+
+  public :
+
+    std::size_t rank(void) const { return _transport.rank(); }
+
+    std::size_t size(void) const { return _transport.size(); }
+
+    void sum(double* data, const std::size_t n) {
+      const auto rank = _transport.rank();
+      const auto size = _transport.size();
+      const auto bytes = n * sizeof(double);
+      if (size <= 1) { return; }
+
+      _buffer.resize(n);
+      for (auto child = 2 * rank + 1; child <= 2 * rank + 2 && child < size; ++child) {
+        _transport.receive(child, _buffer.data(), bytes);
+        for (std::size_t i = 0; i < n; ++i) { data[i] += _buffer[i]; }
+      }
+      if (rank != 0) {
+        _transport.send((rank - 1) / 2, data, bytes);
+        _transport.receive((rank - 1) / 2, data, bytes);
+      }
+      for (auto child = 2 * rank + 1; child <= 2 * rank + 2 && child < size; ++child) {
+        _transport.send(child, data, bytes);
+      }
+    }
+
+    void sum(Eigen::VectorXd& v) {
+      sum(v.data(), v.size());
+    }
+
+    void average(Eigen::VectorXd& v) {
+      sum(v);
+      v /= static_cast<double>(size());
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_PARALLEL_ALLREDUCE_HPP_
@@ -0,0 +1,190 @@
+#ifndef MOCHIMOCHI_PARALLEL_SHARD_POOL_HPP_
+#define MOCHIMOCHI_PARALLEL_SHARD_POOL_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../kernel/dispatch.hpp"
+
+namespace parallel {
+
+  // Model parallelism for very wide dense models : [0, dim) is split into one
+  // contiguous range per thread (aligned to cache lines), and every call runs a
+  // task on all the ranges at once, the calling thread taking the first one.
+  // The threads spin for a while between calls, then sleep ; a pool serves
+  // one caller at a time.
+  class ShardPool {
+  public :
+    // doubles per cache line
+    static constexpr std::size_t kAlign = 8;
+    static constexpr std::size_t kSpins = 1 << 14;
+
+  private :
+    using Task = void (*)(void*, std::size_t, std::size_t, std::size_t);
+
+    // one cache line per shard
+    struct Partial {
+      double first;
+      double second;
+      char padding[64 - 2 * sizeof(double)];
+    };
+
+  private :
+    const std::size_t kDim;
+
+  private :
+    std::vector<std::size_t> _bounds;
+    std::vector<Partial> _partials;
+    Task _task;
+    void* _context;
+    std::atomic<std::uint64_t> _epoch;
+    std::atomic<std::size_t> _pending;
+    std::atomic<bool> _stopping;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::vector<std::thread> _workers;
+
+  private :
+    template <class F>
+    static void invoke(void* context, const std::size_t shard, const std::size_t begin, const std::size_t end) {
+      (*static_cast<F*>(context))(shard, begin, end);
+    }
+
+    void work(const std::size_t shard) {
+      std::uint64_t seen = 0;
+      while (true) {
+        for (std::size_t spin = 0; spin < kSpins && _epoch.load(std::memory_order_acquire) == seen && !_stopping; ++spin) { }
+        if (_epoch.load(std::memory_order_acquire) == seen && !_stopping) {
+          std::unique_lock<std::mutex> lock(_mutex);
+          _wake.wait(lock, [&]() { return _epoch.load(std::memory_order_acquire) != seen || _stopping; });
+        }
+        if (_stopping) { return; }
+
+        seen = _epoch.load(std::memory_order_acquire);
+        _task(_context, shard, _bounds[shard], _bounds[shard + 1]);
+        _pending.fetch_sub(1, std::memory_order_acq_rel);
+      }
+    }
+
+  public :
+    ShardPool(const std::size_t dim, const std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+      : kDim(dim),
+        _partials(std::max<std::size_t>(threads, 1)),
+        _task(nullptr),
+        _context(nullptr),
+        _epoch(0),
+        _pending(0),
+        _stopping(false) {
+      assert(dim > 0);
+      const auto shards = _partials.size();
+      const auto width = ((dim + shards - 1) / shards + kAlign - 1) / kAlign * kAlign;
+      for (std::size_t s = 0; s <= shards; ++s) { _bounds.push_back(std::min(s * width, dim)); }
+      for (std::size_t s = 1; s < shards; ++s) {
+        _workers.emplace_back([this, s]() { work(s); });
+      }
+    }
+
+    ShardPool(const ShardPool&) = delete;
+    ShardPool& operator=(const ShardPool&) = delete;
+
+    virtual ~ShardPool() {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+      }
+      _wake.notify_all();
+      for (auto& worker : _workers) { worker.join(); }
+    }
+
+  public :
+
+    // f(shard, begin, end) on every shard, returns when all of them are done
+    template <class F>
+    void run(F&& f) {
+      using Function = typename std::remove_reference<F>::type;
+      if (_workers.empty()) {
+        f(0, _bounds[0], _bounds[1]);
+        return;
+      }
+
+      _task = &invoke<Function>;
+      _context = const_cast<void*>(static_cast<const void*>(&f));
+      _pending.store(_workers.size(), std::memory_order_relaxed);
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _epoch.fetch_add(1, std::memory_order_release);
+      }
+      _wake.notify_all();
+
+      f(0, _bounds[0], _bounds[1]);
+      while (_pending.load(std::memory_order_acquire) != 0) { std::this_thread::yield(); }
+    }
+
+    // f(begin, end) returns the partial sums of a range, added in shard order
+    template <class F>
+    std::pair<double, double> reduce(F&& f) {
+      run([&](const std::size_t shard, const std::size_t begin, const std::size_t end) {
+            const auto partial = f(begin, end);
+            _partials[shard].first = partial.first;
+            _partials[shard].second = partial.second;
+          });
+      auto result = std::make_pair(0.0, 0.0);
+      for (const auto& partial : _partials) {
+        result.first += partial.first;
+        result.second += partial.second;
+      }
+      return result;
+    }
+
+    std::size_t dimension(void) const { return kDim; }
+
+    std::size_t shards(void) const { return _partials.size(); }
+
+    std::pair<std::size_t, std::size_t> range(const std::size_t shard) const {
+      return std::make_pair(_bounds[shard], _bounds[shard + 1]);
+    }
+  };
+
+  // the dispatched kernels (kernel::kernels) applied shard by shard
+
+  inline double sharded_dot(ShardPool& pool, const Eigen::VectorXd& w, const Eigen::VectorXd& x) {
+    assert(static_cast<std::size_t>(x.size()) == pool.dimension());
+    const auto& k = kernel::kernels();
+    return pool.reduce([&](const std::size_t begin, const std::size_t end) {
+                         return std::make_pair(k.dot(w.data() + begin, x.data() + begin, end - begin), 0.0);
+                       }).first;
+  }
+
+  // margin and confidence in one pass over x
+  inline std::pair<double, double> sharded_margin_confidence(ShardPool& pool, const Eigen::VectorXd& means,
+                                                             const Eigen::VectorXd& covariances,
+                                                             const Eigen::VectorXd& x) {
+    assert(static_cast<std::size_t>(x.size()) == pool.dimension());
+    const auto& k = kernel::kernels();
+    return pool.reduce([&](const std::size_t begin, const std::size_t end) {
+                         return std::make_pair(k.dot(means.data() + begin, x.data() + begin, end - begin),
+                                               k.confidence(covariances.data() + begin, x.data() + begin, end - begin));
+                       });
+  }
+
+  // kernel::update, every shard writing its own range
+  inline void sharded_update(ShardPool& pool, Eigen::VectorXd& means, Eigen::VectorXd& covariances,
+                             const Eigen::VectorXd& x, const double alpha, const double beta) {
+    assert(static_cast<std::size_t>(x.size()) == pool.dimension());
+    const auto& k = kernel::kernels();
+    pool.run([&](const std::size_t, const std::size_t begin, const std::size_t end) {
+               k.update(means.data() + begin, covariances.data() + begin, x.data() + begin, end - begin, alpha, beta);
+             });
+  }
+
+};
+
+#endif //MOCHIMOCHI_PARALLEL_SHARD_POOL_HPP_
@@ -0,0 +1,26 @@
+#ifndef MOCHIMOCHI_PARALLEL_TRANSPORT_HPP_
+#define MOCHIMOCHI_PARALLEL_TRANSPORT_HPP_
+
+#include <cstddef>
+
+namespace parallel {
+
+  // Point to point messages between the `size()` workers of a job, numbered 0 .. size() - 1.
+  // send / receive block until the whole message is transferred and throw std::runtime_error
+  // when a peer is gone. Messages between two workers arrive in the order they were sent.
+  class Transport {
+  public :
+    virtual ~Transport() { }
+
+    virtual std::size_t rank(void) const = 0;
+
+    virtual std::size_t size(void) const = 0;
+
+    virtual void send(const std::size_t peer, const void* data, const std::size_t bytes) = 0;
+
+    virtual void receive(const std::size_t peer, void* data, const std::size_t bytes) = 0;
+  };
+
+};
+
+#endif //MOCHIMOCHI_PARALLEL_TRANSPORT_HPP_
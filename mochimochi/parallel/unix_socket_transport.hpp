@@ -0,0 +1,162 @@
+#ifndef MOCHIMOCHI_PARALLEL_UNIX_SOCKET_TRANSPORT_HPP_
+#define MOCHIMOCHI_PARALLEL_UNIX_SOCKET_TRANSPORT_HPP_
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "./transport.hpp"
+
+namespace parallel {
+
+  // Workers of a single host connected by Unix domain sockets : worker r
+  // listens on "<prefix>.<r>", connects to every lower rank and accepts the
+  // higher ones, so the workers can be started in any order within `timeout`.
+  class UnixSocketTransport : public Transport {
+  private :
+    const std::size_t kRank;
+    const std::size_t kSize;
+    const std::string kPath;
+
+  private :
+    std::vector<int> _peers;
+
+  private :
+    static std::runtime_error system_error(const std::string& message, const std::string& path) {
+      return std::runtime_error(message + " " + path + " : " + std::strerror(errno));
+    }
+
+    static sockaddr_un address_of(const std::string& path) {
+      sockaddr_un address = {};
+      address.sun_family = AF_UNIX;
+      if (path.size() >= sizeof(address.sun_path)) { throw std::runtime_error("Socket path too long : " + path); }
+      path.copy(address.sun_path, path.size());
+      return address;
+    }
+
+    static std::string path_of(const std::string& prefix, const std::size_t rank) {
+      return prefix + "." + std::to_string(rank);
+    }
+
+    // a worker that died must not kill its peers with SIGPIPE
+    static bool write_all(const int fd, const void* data, std::size_t bytes) {
+      auto p = static_cast<const char*>(data);
+      while (bytes > 0) {
+        const auto n = ::send(fd, p, bytes, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) { continue; }
+        if (n <= 0) { return false; }
+        p += n;
+        bytes -= n;
+      }
+      return true;
+    }
+
+    static bool read_all(const int fd, void* data, std::size_t bytes) {
+      auto p = static_cast<char*>(data);
+      while (bytes > 0) {
+        const auto n = ::read(fd, p, bytes);
+        if (n < 0 && errno == EINTR) { continue; }
+        if (n <= 0) { return false; }
+        p += n;
+        bytes -= n;
+      }
+      return true;
+    }
+
+  public :
+    UnixSocketTransport(const std::string& prefix, const std::size_t rank, const std::size_t size,
+                        const std::chrono::milliseconds timeout = std::chrono::milliseconds(30000))
+      : kRank(rank),
+        kSize(size),
+        kPath(path_of(prefix, rank)),
+        _peers(size, -1) {
+      if (rank >= size) { throw std::runtime_error("Invalid rank " + std::to_string(rank)); }
+
+      const auto address = address_of(kPath);
+      const auto listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+      ::unlink(kPath.c_str());
+      if (listener < 0 || ::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+          ::listen(listener, static_cast<int>(size)) != 0) {
+        if (listener >= 0) { ::close(listener); }
+        throw system_error("Cannot listen on", kPath);
+      }
+
+      try {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (std::size_t peer = 0; peer < rank; ++peer) {
+          const auto peer_address = address_of(path_of(prefix, peer));
+          const auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+          if (fd < 0) { throw system_error("Cannot create a socket for", path_of(prefix, peer)); }
+          _peers[peer] = fd;
+          while (::connect(fd, reinterpret_cast<const sockaddr*>(&peer_address), sizeof(peer_address)) != 0) {
+            if (std::chrono::steady_clock::now() >= deadline) { throw system_error("Cannot connect to", path_of(prefix, peer)); }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+          }
+          const std::uint32_t self = static_cast<std::uint32_t>(rank);
+          if (!write_all(fd, &self, sizeof(self))) { throw system_error("Cannot greet", path_of(prefix, peer)); }
+        }
+
+        for (std::size_t n = rank + 1; n < size; ++n) {
+          const auto fd = ::accept(listener, nullptr, nullptr);
+          std::uint32_t peer;
+          if (fd < 0 || !read_all(fd, &peer, sizeof(peer)) || peer <= rank || peer >= size || _peers[peer] >= 0) {
+            if (fd >= 0) { ::close(fd); }
+            throw system_error("Invalid peer on", kPath);
+          }
+          _peers[peer] = fd;
+        }
+      } catch (...) {
+        ::close(listener);
+        close();
+        throw;
+      }
+      ::close(listener);
+    }
+
+    UnixSocketTransport(const UnixSocketTransport&) = delete;
+
+    UnixSocketTransport& operator=(const UnixSocketTransport&) = delete;
+
+    virtual ~UnixSocketTransport() {
+      close();
+    }
+
+  private :
+
+    void close(void) {
+      for (auto& fd : _peers) {
+        if (fd >= 0) { ::close(fd); }
+        fd = -1;
+      }
+      ::unlink(kPath.c_str());
+    }
+
+  public :
+
+    std::size_t rank(void) const override { return kRank; }
+
+    std::size_t size(void) const override { return kSize; }
+
+    void send(const std::size_t peer, const void* data, const std::size_t bytes) override {
+      if (!write_all(_peers.at(peer), data, bytes)) {
+        throw std::runtime_error("Lost worker " + std::to_string(peer));
+      }
+    }
+
+    void receive(const std::size_t peer, void* data, const std::size_t bytes) override {
+      if (!read_all(_peers.at(peer), data, bytes)) {
+        throw std::runtime_error("Lost worker " + std::to_string(peer));
+      }
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_PARALLEL_UNIX_SOCKET_TRANSPORT_HPP_
@@ -0,0 +1,6 @@
+#ifndef MOCHIMOCHI_SAMPLING_HPP_
+#define MOCHIMOCHI_SAMPLING_HPP_
+
+#include "./sampling/selective_sampler.hpp"
+
+#endif //MOCHIMOCHI_SAMPLING_HPP_
@@ -0,0 +1,98 @@
+#ifndef MOCHIMOCHI_SAMPLING_SELECTIVE_SAMPLER_HPP_
+#define MOCHIMOCHI_SAMPLING_SELECTIVE_SAMPLER_HPP_
+
+#include <Eigen/Dense>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <utility>
+
+namespace sampling {
+
+  // kMargin : learn only when |margin| <= threshold * sqrt(confidence),
+  //           i.e. the example lies within `threshold` standard deviations of the boundary.
+  // kProbabilistic : learn with probability threshold / (threshold + |margin|)
+  //           (Cesa-Bianchi et al., Worst-Case Analysis of Selective Sampling for Linear Classification).
+  enum class Rule { kMargin, kProbabilistic };
+
+  // Selective sampling for the confidence weighted learners (AROW, SCW) :
+  // the decision only needs the margin (and the confidence), which are
+  // handed to the learner so that a queried example is not scored twice.
+  template <class Learner>
+  class SelectiveSampler {
+  private :
+    const Rule kRule;
+    const double kThreshold;
+
+  private :
+    Learner _learner;
+    std::mt19937 _engine;
+    std::uniform_real_distribution<double> _uniform;
+    std::uint64_t _seen;
+    std::uint64_t _queried;
+
+  public :
+    SelectiveSampler(const Rule rule, const double threshold, Learner learner, const unsigned int seed = 1)
+      : kRule(rule),
+        kThreshold(threshold),
+        _learner(std::move(learner)),
+        _engine(seed),
+        _uniform(0.0, 1.0),
+        _seen(0),
+        _queried(0) {
+      assert(threshold > 0);
+    }
+
+    virtual ~SelectiveSampler() { }
+
+  public :
+
+    // false when the example was skipped or did not change the model
+    bool update(const Eigen::VectorXd& feature, const int label) {
+      ++_seen;
+      const auto margin = _learner.compute_margin(feature);
+      if (kRule == Rule::kMargin) {
+        const auto confidence = _learner.compute_confidence(feature);
+        if (std::abs(margin) > kThreshold * std::sqrt(confidence)) { return false; }
+        ++_queried;
+        return _learner.update(feature, label, margin, confidence);
+      }
+
+      if (_uniform(_engine) >= kThreshold / (kThreshold + std::abs(margin))) { return false; }
+      ++_queried;
+      return _learner.update(feature, label, margin, _learner.compute_confidence(feature));
+    }
+
+    double compute_margin(const Eigen::VectorXd& x) const {
+      return _learner.compute_margin(x);
+    }
+
+    int predict(const Eigen::VectorXd& x) const {
+      return _learner.predict(x);
+    }
+
+    std::uint64_t seen(void) const { return _seen; }
+
+    std::uint64_t queried(void) const { return _queried; }
+
+    std::uint64_t skipped(void) const { return _seen - _queried; }
+
+    double query_rate(void) const {
+      return _seen == 0 ? 0.0 : static_cast<double>(_queried) / _seen;
+    }
+
+    Learner& learner(void) { return _learner; }
+
+    const Learner& learner(void) const { return _learner; }
+  };
+
+  template <class Learner>
+  SelectiveSampler<Learner> make_selective_sampler(const Rule rule, const double threshold, Learner learner,
+                                                   const unsigned int seed = 1) {
+    return SelectiveSampler<Learner>(rule, threshold, std::move(learner), seed);
+  }
+
+};
+
+#endif //MOCHIMOCHI_SAMPLING_SELECTIVE_SAMPLER_HPP_
@@ -0,0 +1,7 @@
+#ifndef MOCHIMOCHI_SERVING_HPP_
+#define MOCHIMOCHI_SERVING_HPP_
+
+#include "./serving/micro_batcher.hpp"
+#include "./serving/shared_model.hpp"
+
+#endif //MOCHIMOCHI_SERVING_HPP_
@@ -0,0 +1,146 @@
+#ifndef MOCHIMOCHI_SERVING_MICRO_BATCHER_HPP_
+#define MOCHIMOCHI_SERVING_MICRO_BATCHER_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace serving {
+
+  // Groups concurrent requests into batches : a worker takes up to max_batch
+  // requests, waiting at most max_delay after the oldest one arrived, and
+  // hands them to the handler in one call.
+  template <class Request, class Response>
+  class MicroBatcher {
+  public :
+    using Handler = std::function<void(const std::vector<Request>&, std::vector<Response>&)>;
+
+  private :
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending {
+      Request request;
+      std::promise<Response> promise;
+      Clock::time_point arrival;
+    };
+
+  private :
+    const std::size_t kMaxBatch;
+    const std::chrono::microseconds kMaxDelay;
+
+  private :
+    Handler _handler;
+    std::mutex _mutex;
+    std::condition_variable _ready;
+    std::deque<Pending> _queue;
+    bool _stopping;
+    std::vector<std::thread> _workers;
+
+  public :
+    MicroBatcher(Handler handler, const std::size_t workers, const std::size_t max_batch,
+                 const std::chrono::microseconds max_delay)
+      : kMaxBatch(max_batch),
+        kMaxDelay(max_delay),
+        _handler(std::move(handler)),
+        _stopping(false) {
+      assert(workers > 0);
+      assert(max_batch > 0);
+      for (std::size_t i = 0; i < workers; ++i) {
+        _workers.emplace_back([this]() { run(); });
+      }
+    }
+
+    MicroBatcher(const MicroBatcher&) = delete;
+    MicroBatcher& operator=(const MicroBatcher&) = delete;
+
+    virtual ~MicroBatcher() {
+      stop();
+    }
+
+  private :
+
+    void run(void) {
+      std::vector<Request> requests;
+      std::vector<std::promise<Response>> promises;
+      std::vector<Response> responses;
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(_mutex);
+          _ready.wait(lock, [&]() { return _stopping || !_queue.empty(); });
+          if (_queue.empty()) { return; }
+
+          const auto deadline = _queue.front().arrival + kMaxDelay;
+          _ready.wait_until(lock, deadline, [&]() { return _stopping || _queue.size() >= kMaxBatch; });
+          if (_queue.empty()) { continue; }
+
+          while (!_queue.empty() && requests.size() < kMaxBatch) {
+            requests.push_back(std::move(_queue.front().request));
+            promises.push_back(std::move(_queue.front().promise));
+            _queue.pop_front();
+          }
+          if (!_queue.empty()) { _ready.notify_one(); }
+        }
+
+        try {
+          responses.clear();
+          _handler(requests, responses);
+        } catch (...) {
+          for (auto& promise : promises) { promise.set_exception(std::current_exception()); }
+          responses.clear();
+          promises.clear();
+        }
+        // a handler returning too few responses fails the requests it left unanswered
+        const auto answered = std::min(responses.size(), promises.size());
+        for (std::size_t i = 0; i < answered; ++i) { promises[i].set_value(std::move(responses[i])); }
+        for (std::size_t i = answered; i < promises.size(); ++i) {
+          promises[i].set_exception(std::make_exception_ptr(std::runtime_error("MicroBatcher : no response from the handler")));
+        }
+        requests.clear();
+        promises.clear();
+      }
+    }
+
+  public :
+
+    // after stop the future fails at once, no worker is left to answer it
+    std::future<Response> submit(Request request) {
+      std::promise<Response> promise;
+      auto future = promise.get_future();
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_stopping) {
+          promise.set_exception(std::make_exception_ptr(std::runtime_error("MicroBatcher : stopped")));
+          return future;
+        }
+        _queue.push_back(Pending { std::move(request), std::move(promise), Clock::now() });
+      }
+      _ready.notify_one();
+      return future;
+    }
+
+    // the queued requests are still answered before the workers exit
+    void stop(void) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+      }
+      _ready.notify_all();
+      for (auto& worker : _workers) {
+        if (worker.joinable()) { worker.join(); }
+      }
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_SERVING_MICRO_BATCHER_HPP_
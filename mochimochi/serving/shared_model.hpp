@@ -0,0 +1,178 @@
+#ifndef MOCHIMOCHI_SERVING_SHARED_MODEL_HPP_
+#define MOCHIMOCHI_SERVING_SHARED_MODEL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../inference/frozen_model.hpp"
+
+// Publishing frozen models to the serving processes of a host.
+// Every version is written once to its own file "<prefix>.<generation>" and
+// the file "<prefix>" holds the current generation in a shared mapping.
+// Readers map the versions read-only, so all processes share one copy of the
+// weights in the page cache ("/dev/shm/..." keeps it in memory), and switch by
+// reading the generation counter. A version is unlinked once the next one is
+// published; processes still mapping it keep using it until they switch.
+namespace serving {
+
+  namespace detail {
+    constexpr char kControlMagic[8] = { 'M', 'O', 'C', 'H', 'I', 'P', 'U', 'B' };
+
+    // lives in the shared mapping, so the counter has to be lock free (it is on 64 bit targets)
+    struct Control {
+      char magic[8];
+      std::atomic<std::uint64_t> generation;
+    };
+
+    inline std::string version_path(const std::string& prefix, const std::uint64_t generation) {
+      return prefix + "." + std::to_string(generation);
+    }
+
+    inline std::runtime_error system_error(const std::string& message, const std::string& path) {
+      return std::runtime_error(message + " " + path + " : " + std::strerror(errno));
+    }
+
+    // maps the control file, creating it when writable is set
+    inline std::shared_ptr<Control> map_control(const std::string& prefix, const bool writable) {
+      const auto fd = ::open(prefix.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+      if (fd < 0) { throw system_error("Cannot open", prefix); }
+      if (writable && ::ftruncate(fd, sizeof(Control)) != 0) {
+        ::close(fd);
+        throw system_error("Cannot resize", prefix);
+      }
+      const auto address = ::mmap(nullptr, sizeof(Control), writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                                  MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (address == MAP_FAILED) { throw system_error("Cannot map", prefix); }
+
+      const auto control = static_cast<Control*>(address);
+      if (writable && !std::equal(kControlMagic, kControlMagic + 8, control->magic)) {
+        control->generation.store(0, std::memory_order_relaxed);
+        std::copy(kControlMagic, kControlMagic + 8, control->magic);
+      }
+      if (!std::equal(kControlMagic, kControlMagic + 8, control->magic)) {
+        ::munmap(address, sizeof(Control));
+        throw std::runtime_error("Not a model publication : " + prefix);
+      }
+      return std::shared_ptr<Control>(control, [](Control* p) { ::munmap(p, sizeof(Control)); });
+    }
+  };
+
+  // Trainer side : a single publisher per prefix.
+  template <typename T>
+  class ModelPublisher {
+  private :
+    const std::string kPrefix;
+
+  private :
+    std::shared_ptr<detail::Control> _control;
+
+  public :
+    explicit ModelPublisher(const std::string& prefix)
+      : kPrefix(prefix),
+        _control(detail::map_control(prefix, true)) { }
+
+    virtual ~ModelPublisher() { }
+
+  public :
+
+    // the version is complete on disk before the generation is bumped
+    std::uint64_t publish(const inference::FrozenModel<T>& model) {
+      const auto previous = _control->generation.load(std::memory_order_acquire);
+      const auto generation = previous + 1;
+      model.save(detail::version_path(kPrefix, generation));
+      _control->generation.store(generation, std::memory_order_release);
+      if (previous > 0) { ::unlink(detail::version_path(kPrefix, previous).c_str()); }
+      return generation;
+    }
+
+    std::uint64_t generation(void) const {
+      return _control->generation.load(std::memory_order_acquire);
+    }
+  };
+
+  // Serving side : refresh() switches to the latest version when there is one,
+  // get() returns the current model (nullptr before the first version).
+  template <typename T>
+  class SharedModel {
+  private :
+    using Model = inference::FrozenModel<T>;
+
+  private :
+    const std::string kPrefix;
+
+  private :
+    std::shared_ptr<const detail::Control> _control;
+    std::shared_ptr<const Model> _model;
+    std::atomic<std::uint64_t> _generation;
+
+  private :
+
+    // nullptr when the version was replaced (and unlinked) before it could be opened
+    static std::shared_ptr<const Model> map_version(const std::string& path) {
+      const auto fd = ::open(path.c_str(), O_RDONLY);
+      if (fd < 0) {
+        if (errno == ENOENT) { return nullptr; }
+        throw detail::system_error("Cannot open", path);
+      }
+      struct stat st;
+      if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw detail::system_error("Cannot stat", path);
+      }
+      const std::size_t size = st.st_size;
+      const auto address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (address == MAP_FAILED) { throw detail::system_error("Cannot map", path); }
+
+      std::shared_ptr<const void> memory(address, [size](const void* p) { ::munmap(const_cast<void*>(p), size); });
+      return std::make_shared<const Model>(Model::map(memory, static_cast<const char*>(address), size));
+    }
+
+  public :
+    explicit SharedModel(const std::string& prefix)
+      : kPrefix(prefix),
+        _control(detail::map_control(prefix, false)),
+        _generation(0) {
+      refresh();
+    }
+
+    virtual ~SharedModel() { }
+
+  public :
+
+    // true when a new version was mapped
+    bool refresh(void) {
+      while (true) {
+        const auto generation = _control->generation.load(std::memory_order_acquire);
+        if (generation == 0 || generation == _generation.load()) { return false; }
+        const auto model = map_version(detail::version_path(kPrefix, generation));
+        if (model) {
+          std::atomic_store(&_model, model);
+          _generation.store(generation);
+          return true;
+        }
+      }
+    }
+
+    std::shared_ptr<const Model> get(void) const {
+      return std::atomic_load(&_model);
+    }
+
+    std::uint64_t generation(void) const {
+      return _generation.load();
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_SERVING_SHARED_MODEL_HPP_
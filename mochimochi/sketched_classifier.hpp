@@ -0,0 +1,8 @@
+#ifndef MOCHIMOCHI_SKETCHED_CLASSIFIER_HPP_
+#define MOCHIMOCHI_SKETCHED_CLASSIFIER_HPP_
+
+#include "./classifier/sketched/covariance.hpp"
+#include "./classifier/sketched/arow.hpp"
+#include "./classifier/sketched/scw.hpp"
+
+#endif //MOCHIMOCHI_SKETCHED_CLASSIFIER_HPP_
@@ -0,0 +1,7 @@
+#ifndef MOCHIMOCHI_STATS_HPP_
+#define MOCHIMOCHI_STATS_HPP_
+
+#include "./stats/training_stats.hpp"
+#include "./stats/instrumented.hpp"
+
+#endif //MOCHIMOCHI_STATS_HPP_
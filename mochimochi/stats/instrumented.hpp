@@ -0,0 +1,129 @@
+#ifndef MOCHIMOCHI_STATS_INSTRUMENTED_HPP_
+#define MOCHIMOCHI_STATS_INSTRUMENTED_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include "./training_stats.hpp"
+
+namespace stats {
+
+  namespace detail {
+    struct Outcome {
+      double loss;
+      bool mistake;
+    };
+
+    // binary learners : hinge loss of compute_margin
+    template <class Learner>
+    auto evaluate(const Learner& learner, const Eigen::VectorXd& x, const int label, int)
+      -> decltype(learner.compute_margin(x), Outcome()) {
+      const auto margin = learner.compute_margin(x);
+      return { std::max(0.0, 1.0 - label * margin), ((margin > 0.0) ? 1 : -1) != label };
+    }
+
+    // multi-class learners : multi-class hinge loss of compute_scores
+    template <class Learner>
+    auto evaluate(const Learner& learner, const Eigen::VectorXd& x, const std::size_t label, long)
+      -> decltype(learner.compute_scores(x), Outcome()) {
+      const Eigen::VectorXd scores = learner.compute_scores(x);
+      const auto correct = scores[label - 1];
+      auto rival = -std::numeric_limits<double>::infinity();
+      for (std::size_t k = 0; k < static_cast<std::size_t>(scores.size()); ++k) {
+        if (k != label - 1) { rival = std::max(rival, scores[k]); }
+      }
+      return { std::max(0.0, 1.0 - (correct - rival)), rival >= correct };
+    }
+
+    // the one-vs-rest learners return void, every example counts as an update
+    template <class Learner, typename Label>
+    bool apply(Learner& learner, const Eigen::VectorXd& x, const Label label, std::true_type /* void */) {
+      learner.update(x, label);
+      return true;
+    }
+
+    template <class Learner, typename Label>
+    bool apply(Learner& learner, const Eigen::VectorXd& x, const Label label, std::false_type) {
+      return learner.update(x, label);
+    }
+
+    // AROW / SCW : the margin and the confidence are computed once and handed to the update
+    template <class Learner, typename Label>
+    auto train(Learner& learner, const Eigen::VectorXd& x, const Label label, bool& applied, int)
+      -> decltype(learner.update(x, label, 0.0, 0.0), Outcome()) {
+      const auto margin = learner.compute_margin(x);
+      applied = learner.update(x, label, margin, learner.compute_confidence(x));
+      return { std::max(0.0, 1.0 - label * margin), ((margin > 0.0) ? 1 : -1) != label };
+    }
+
+    // the other learners are scored before the update, one more pass over the example
+    template <class Learner, typename Label>
+    Outcome train(Learner& learner, const Eigen::VectorXd& x, const Label label, bool& applied, long) {
+      using Void = std::is_void<decltype(learner.update(x, label))>;
+      const auto outcome = evaluate(learner, x, label, 0);
+      applied = apply(learner, x, label, Void());
+      return outcome;
+    }
+
+    // keeps the variadic constructor of Instrumented from taking over its copy constructor
+    template <class Self, typename... Args>
+    struct is_self : std::false_type { };
+
+    template <class Self, typename Arg>
+    struct is_self<Self, Arg> : std::is_same<typename std::decay<Arg>::type, Self> { };
+  };
+
+  // Wraps any learner, recording the progressive (before update) loss and
+  // mistakes, the applied / skipped updates and the update / predict latency.
+  // AROW and SCW reuse the margin of the update ; the other learners are scored
+  // once more before the update. With MOCHIMOCHI_NO_STATS the calls are forwarded as is.
+  template <class Learner>
+  class Instrumented {
+  private :
+    Learner _learner;
+    mutable TrainingStats _stats;
+
+  public :
+    template <typename... Args, typename = typename std::enable_if<!detail::is_self<Instrumented, Args...>::value>::type>
+    explicit Instrumented(Args&&... args)
+      : _learner(std::forward<Args>(args)...) { }
+
+    template <typename Label>
+    bool update(const Eigen::VectorXd& feature, const Label label) {
+#ifndef MOCHIMOCHI_NO_STATS
+      const Timer timer;
+      auto applied = false;
+      const auto outcome = detail::train(_learner, feature, label, applied, 0);
+      _stats.record_update(applied, outcome.loss, outcome.mistake, timer.elapsed());
+      return applied;
+#else
+      using Void = std::is_void<decltype(_learner.update(feature, label))>;
+      return detail::apply(_learner, feature, label, Void());
+#endif
+    }
+
+    auto predict(const Eigen::VectorXd& feature) const -> decltype(_learner.predict(feature)) {
+#ifndef MOCHIMOCHI_NO_STATS
+      const Timer timer;
+      const auto label = _learner.predict(feature);
+      _stats.record_predict(timer.elapsed());
+      return label;
+#else
+      return _learner.predict(feature);
+#endif
+    }
+
+    Learner& learner(void) { return _learner; }
+
+    const Learner& learner(void) const { return _learner; }
+
+    TrainingStats& stats(void) { return _stats; }
+
+    const TrainingStats& stats(void) const { return _stats; }
+  };
+
+};
+
+#endif //MOCHIMOCHI_STATS_INSTRUMENTED_HPP_
@@ -0,0 +1,175 @@
+#ifndef MOCHIMOCHI_STATS_TRAINING_STATS_HPP_
+#define MOCHIMOCHI_STATS_TRAINING_STATS_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Define MOCHIMOCHI_NO_STATS to compile every recording call into a no-op.
+namespace stats {
+
+  // Latencies in nanoseconds, bucket i holding [2^(i-1), 2^i).
+  class LatencyHistogram {
+  public :
+    static constexpr std::size_t kBuckets = 48;
+
+  private :
+    std::array<std::uint64_t, kBuckets> _counts;
+    std::uint64_t _total;
+    double _sum;
+
+  public :
+    LatencyHistogram() : _counts(), _total(0), _sum(0.0) { }
+
+    void record(const std::uint64_t nanoseconds) {
+      std::size_t bucket = 0;
+      for (auto v = nanoseconds; v > 0 && bucket + 1 < kBuckets; v >>= 1) { ++bucket; }
+      ++_counts[bucket];
+      ++_total;
+      _sum += nanoseconds;
+    }
+
+    std::uint64_t count(void) const { return _total; }
+
+    std::uint64_t bucket(const std::size_t i) const { return _counts[i]; }
+
+    double mean(void) const { return _total == 0 ? 0.0 : _sum / _total; }
+
+    double seconds(void) const { return _sum * 1e-9; }
+
+    // upper bound (in nanoseconds) of the bucket holding the q-quantile
+    std::uint64_t quantile(const double q) const {
+      if (_total == 0) { return 0; }
+      const auto rank = static_cast<std::uint64_t>(q * _total);
+      std::uint64_t seen = 0;
+      for (std::size_t i = 0; i < kBuckets; ++i) {
+        seen += _counts[i];
+        if (seen > rank) { return i == 0 ? 0 : (std::uint64_t(1) << i) - 1; }
+      }
+      return (std::uint64_t(1) << (kBuckets - 1)) - 1;
+    }
+
+    void merge(const LatencyHistogram& other) {
+      for (std::size_t i = 0; i < kBuckets; ++i) { _counts[i] += other._counts[i]; }
+      _total += other._total;
+      _sum += other._sum;
+    }
+  };
+
+  class Timer {
+#ifndef MOCHIMOCHI_NO_STATS
+  private :
+    std::chrono::steady_clock::time_point _start;
+
+  public :
+    Timer() : _start(std::chrono::steady_clock::now()) { }
+
+    std::uint64_t elapsed(void) const {
+      const auto now = std::chrono::steady_clock::now();
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(now - _start).count();
+    }
+#else
+  public :
+    std::uint64_t elapsed(void) const { return 0; }
+#endif
+  };
+
+  class TrainingStats {
+  private :
+    std::uint64_t _examples;
+    std::uint64_t _updates;
+    std::uint64_t _mistakes;
+    double _loss;
+    LatencyHistogram _parse;
+    LatencyHistogram _update;
+    LatencyHistogram _predict;
+
+  public :
+    TrainingStats() : _examples(0), _updates(0), _mistakes(0), _loss(0.0) { }
+
+#ifndef MOCHIMOCHI_NO_STATS
+    void record_parse(const std::uint64_t nanoseconds) {
+      _parse.record(nanoseconds);
+    }
+
+    // loss and mistake are those of the model before the update
+    void record_update(const bool applied, const double loss, const bool mistake, const std::uint64_t nanoseconds) {
+      ++_examples;
+      if (applied) { ++_updates; }
+      if (mistake) { ++_mistakes; }
+      _loss += loss;
+      _update.record(nanoseconds);
+    }
+
+    void record_predict(const std::uint64_t nanoseconds) {
+      _predict.record(nanoseconds);
+    }
+#else
+    void record_parse(const std::uint64_t) { }
+    void record_update(const bool, const double, const bool, const std::uint64_t) { }
+    void record_predict(const std::uint64_t) { }
+#endif
+
+    std::uint64_t examples(void) const { return _examples; }
+
+    std::uint64_t updates(void) const { return _updates; }
+
+    std::uint64_t skipped(void) const { return _examples - _updates; }
+
+    std::uint64_t mistakes(void) const { return _mistakes; }
+
+    double cumulative_loss(void) const { return _loss; }
+
+    double mistake_rate(void) const {
+      return _examples == 0 ? 0.0 : static_cast<double>(_mistakes) / _examples;
+    }
+
+    double average_loss(void) const {
+      return _examples == 0 ? 0.0 : _loss / _examples;
+    }
+
+    const LatencyHistogram& parse_latency(void) const { return _parse; }
+
+    const LatencyHistogram& update_latency(void) const { return _update; }
+
+    const LatencyHistogram& predict_latency(void) const { return _predict; }
+
+    void merge(const TrainingStats& other) {
+      _examples += other._examples;
+      _updates += other._updates;
+      _mistakes += other._mistakes;
+      _loss += other._loss;
+      _parse.merge(other._parse);
+      _update.merge(other._update);
+      _predict.merge(other._predict);
+    }
+
+    void reset(void) {
+      *this = TrainingStats();
+    }
+  };
+
+  inline std::ostream& operator<<(std::ostream& os, const LatencyHistogram& histogram) {
+    return os << "count=" << histogram.count()
+              << " seconds=" << histogram.seconds()
+              << " mean_ns=" << histogram.mean()
+              << " p50_ns=" << histogram.quantile(0.5)
+              << " p99_ns=" << histogram.quantile(0.99);
+  }
+
+  inline std::ostream& operator<<(std::ostream& os, const TrainingStats& stats) {
+    return os << "examples=" << stats.examples()
+              << " updates=" << stats.updates()
+              << " skipped=" << stats.skipped()
+              << " mistakes=" << stats.mistakes()
+              << " mistake_rate=" << stats.mistake_rate()
+              << " cumulative_loss=" << stats.cumulative_loss() << "\n"
+              << "parse   : " << stats.parse_latency() << "\n"
+              << "update  : " << stats.update_latency() << "\n"
+              << "predict : " << stats.predict_latency();
+  }
+
+};
+
+#endif //MOCHIMOCHI_STATS_TRAINING_STATS_HPP_
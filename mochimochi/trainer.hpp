@@ -0,0 +1,10 @@
+#ifndef MOCHIMOCHI_TRAINER_HPP_
+#define MOCHIMOCHI_TRAINER_HPP_
+
+#include "./trainer/progressive_metrics.hpp"
+#include "./trainer/online_trainer.hpp"
+#include "./trainer/sweep_trainer.hpp"
+#include "./trainer/data_parallel_trainer.hpp"
+#include "./trainer/delayed_feedback.hpp"
+
+#endif //MOCHIMOCHI_TRAINER_HPP_
@@ -0,0 +1,101 @@
+#ifndef MOCHIMOCHI_TRAINER_DATA_PARALLEL_TRAINER_HPP_
+#define MOCHIMOCHI_TRAINER_DATA_PARALLEL_TRAINER_HPP_
+
+#include <Eigen/Dense>
+#include <cassert>
+#include <istream>
+#include <string>
+#include <utility>
+#include "../parallel/allreduce.hpp"
+#include "../parallel/transport.hpp"
+#include "../utility/load_svmlight_file.hpp"
+#include "./online_trainer.hpp"
+
+namespace trainer {
+
+  // Synchronous data parallel training : every worker of the transport learns
+  // its own shard and, every `interval` examples, the learners are merged by
+  // Learner::synchronize(parallel::Allreduce&) (ADAM, ADAGRAD_RDA, PA).
+  // A worker that ran out of data keeps taking part in the merges (see finish)
+  // until all the workers are done, so they end with the same model.
+  template <class Learner>
+  class DataParallelTrainer {
+  public :
+    using Label = typename OnlineTrainer<Learner>::Label;
+
+  private :
+    const std::size_t kInterval;
+
+  private :
+    parallel::Allreduce _allreduce;
+    OnlineTrainer<Learner> _trainer;
+    std::size_t _pending;
+    std::size_t _rounds;
+
+  public :
+    template <typename... Args>
+    DataParallelTrainer(parallel::Transport& transport, const std::size_t interval, Args&&... args)
+      : kInterval(interval),
+        _allreduce(transport),
+        _trainer(std::forward<Args>(args)...),
+        _pending(0),
+        _rounds(0) {
+      assert(interval > 0);
+    }
+
+  private :
+
+    // true while some worker still has data
+    bool synchronize(const bool active) {
+      double workers = active ? 1.0 : 0.0;
+      _allreduce.sum(&workers, 1);
+      _trainer.learner().synchronize(_allreduce);
+      _pending = 0;
+      ++_rounds;
+      return workers > 0.0;
+    }
+
+  public :
+
+    void learn(const Eigen::VectorXd& feature, const Label label) {
+      _trainer.learn(feature, label);
+      if (++_pending == kInterval) { synchronize(true); }
+    }
+
+    // called once the shard is exhausted, returns when every worker has finished
+    void finish(void) {
+      while (synchronize(false)) { }
+    }
+
+    // svmlight formatted stream shared by all the workers : the worker of rank r
+    // learns the examples r, r + size, r + 2 size, ... then finishes.
+    // Returns the number of examples learned by this worker.
+    std::size_t train(std::istream& is, const std::size_t dim) {
+      std::size_t count = 0;
+      std::size_t line_number = 0;
+      std::string line;
+      Eigen::VectorXd x = Eigen::VectorXd::Zero(dim);
+      while (std::getline(is, line)) {
+        if (line.empty()) { continue; }
+        if (line_number++ % _allreduce.size() != _allreduce.rank()) { continue; }
+        const auto label = utility::read_ones<Label>(line, x);
+        learn(x, label);
+        ++count;
+      }
+      finish();
+      return count;
+    }
+
+    std::size_t rounds(void) const { return _rounds; }
+
+    Learner& learner(void) { return _trainer.learner(); }
+
+    const Learner& learner(void) const { return _trainer.learner(); }
+
+    // progressive validation on this worker's shard
+    const ProgressiveMetrics& metrics(void) const { return _trainer.metrics(); }
+  };
+
+};
+
+#endif //MOCHIMOCHI_TRAINER_DATA_PARALLEL_TRAINER_HPP_
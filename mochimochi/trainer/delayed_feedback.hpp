@@ -0,0 +1,185 @@
+#ifndef MOCHIMOCHI_TRAINER_DELAYED_FEEDBACK_HPP_
+#define MOCHIMOCHI_TRAINER_DELAYED_FEEDBACK_HPP_
+
+#include <Eigen/Dense>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "./progressive_metrics.hpp"
+
+namespace trainer {
+
+  // Online learning from labels that arrive after the prediction (clicks, conversions) :
+  // predict keeps the nonzero features of the example (uint32 index, float32 value)
+  // and its margin under a request id, and feedback learns the example when its
+  // label arrives, so the features are not sent again with the label.
+  // A prediction still waiting after `ttl`, or the oldest one when `capacity`
+  // predictions are waiting, is learned with the default label (-1 : no click).
+  // The metrics are those of the predictions actually served (progressive validation
+  // on the predict time margins). Binary learners ; not thread safe.
+  template <class Learner>
+  class DelayedFeedback {
+  public :
+    using Clock = std::chrono::steady_clock;
+
+  private :
+    static constexpr std::size_t kNone = static_cast<std::size_t>(-1);
+
+    struct Pending {
+      std::uint64_t id;
+      Clock::time_point deadline;
+      double margin;
+      std::vector<std::uint32_t> indices;
+      std::vector<float> values;
+      // arrival order of the waiting predictions
+      std::size_t previous;
+      std::size_t next;
+    };
+
+  private :
+    const std::size_t kCapacity;
+    const Clock::duration kTTL;
+    const int kDefault;
+
+  private :
+    Learner _learner;
+    ProgressiveMetrics _metrics;
+    std::vector<Pending> _slots;
+    std::vector<std::size_t> _free;
+    std::unordered_map<std::uint64_t, std::size_t> _index;
+    std::size_t _oldest;
+    std::size_t _newest;
+    Eigen::VectorXd _x;
+    std::uint64_t _joined;
+    std::uint64_t _expired;
+    std::uint64_t _evicted;
+    std::uint64_t _unknown;
+
+  private :
+
+    void unlink(const std::size_t slot) {
+      auto& pending = _slots[slot];
+      (pending.previous == kNone ? _oldest : _slots[pending.previous].next) = pending.next;
+      (pending.next == kNone ? _newest : _slots[pending.next].previous) = pending.previous;
+      _index.erase(pending.id);
+      _free.push_back(slot);
+    }
+
+    void learn(const std::size_t slot, const int label) {
+      const auto& pending = _slots[slot];
+      for (std::size_t i = 0; i < pending.indices.size(); ++i) { _x[pending.indices[i]] = pending.values[i]; }
+      _metrics.add(pending.margin, label);
+      _learner.update(_x, label);
+      for (const auto i : pending.indices) { _x[i] = 0.0; }
+      unlink(slot);
+    }
+
+  public :
+    template <typename... Args>
+    DelayedFeedback(const std::size_t capacity, const Clock::duration ttl, const int default_label, Args&&... args)
+      : kCapacity(capacity),
+        kTTL(ttl),
+        kDefault(default_label),
+        _learner(std::forward<Args>(args)...),
+        _slots(capacity),
+        _oldest(kNone),
+        _newest(kNone),
+        _joined(0),
+        _expired(0),
+        _evicted(0),
+        _unknown(0) {
+      assert(capacity > 0);
+      for (std::size_t slot = capacity; slot > 0; --slot) { _free.push_back(slot - 1); }
+      _index.reserve(capacity);
+    }
+
+  public :
+
+    // scores the example and keeps it until its label arrives, returns the margin ;
+    // a prediction already waiting under the same id is dropped without being learned
+    double predict(const std::uint64_t id, const Eigen::VectorXd& feature, const Clock::time_point now = Clock::now()) {
+      expire(now);
+      const auto found = _index.find(id);
+      if (found != _index.end()) { unlink(found->second); }
+      if (_free.empty()) {
+        learn(_oldest, kDefault);
+        ++_evicted;
+      }
+      if (_x.size() != feature.size()) { _x = Eigen::VectorXd::Zero(feature.size()); }
+
+      const auto slot = _free.back();
+      _free.pop_back();
+      auto& pending = _slots[slot];
+      pending.id = id;
+      pending.deadline = now + kTTL;
+      pending.margin = _learner.compute_margin(feature);
+      pending.indices.clear();
+      pending.values.clear();
+      for (std::size_t i = 0; i < static_cast<std::size_t>(feature.size()); ++i) {
+        if (feature[i] == 0.0) { continue; }
+        pending.indices.push_back(static_cast<std::uint32_t>(i));
+        pending.values.push_back(static_cast<float>(feature[i]));
+      }
+      pending.previous = _newest;
+      pending.next = kNone;
+      (_newest == kNone ? _oldest : _slots[_newest].next) = slot;
+      _newest = slot;
+      _index.emplace(id, slot);
+      return pending.margin;
+    }
+
+    // false when no prediction waits under this id (never made, expired or already labeled)
+    bool feedback(const std::uint64_t id, const int label, const Clock::time_point now = Clock::now()) {
+      expire(now);
+      const auto found = _index.find(id);
+      if (found == _index.end()) {
+        ++_unknown;
+        return false;
+      }
+      learn(found->second, label);
+      ++_joined;
+      return true;
+    }
+
+    // learns the predictions older than the ttl with the default label, returns their number
+    std::size_t expire(const Clock::time_point now = Clock::now()) {
+      std::size_t count = 0;
+      while (_oldest != kNone && _slots[_oldest].deadline <= now) {
+        learn(_oldest, kDefault);
+        ++count;
+      }
+      _expired += count;
+      return count;
+    }
+
+    // learns every waiting prediction with the default label (end of the stream)
+    void flush(void) {
+      while (_oldest != kNone) {
+        learn(_oldest, kDefault);
+        ++_expired;
+      }
+    }
+
+    std::size_t pending(void) const { return _index.size(); }
+
+    std::uint64_t joined(void) const { return _joined; }
+
+    std::uint64_t expired(void) const { return _expired; }
+
+    std::uint64_t evicted(void) const { return _evicted; }
+
+    std::uint64_t unknown(void) const { return _unknown; }
+
+    Learner& learner(void) { return _learner; }
+
+    const Learner& learner(void) const { return _learner; }
+
+    const ProgressiveMetrics& metrics(void) const { return _metrics; }
+  };
+
+};
+
+#endif //MOCHIMOCHI_TRAINER_DELAYED_FEEDBACK_HPP_
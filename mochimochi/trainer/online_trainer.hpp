@@ -0,0 +1,87 @@
+#ifndef MOCHIMOCHI_TRAINER_ONLINE_TRAINER_HPP_
+#define MOCHIMOCHI_TRAINER_ONLINE_TRAINER_HPP_
+
+#include <Eigen/Dense>
+#include <istream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "../utility/load_svmlight_file.hpp"
+#include "./progressive_metrics.hpp"
+
+namespace trainer {
+
+  namespace detail {
+    // binary learners expose compute_margin and take labels +1 / -1,
+    // multi-class learners expose compute_scores and take labels 1 .. K
+    template <class Learner>
+    auto label_of(const Learner& learner, int) -> decltype(learner.compute_margin(Eigen::VectorXd()), int());
+
+    template <class Learner>
+    auto label_of(const Learner& learner, long) -> decltype(learner.compute_scores(Eigen::VectorXd()), std::size_t());
+
+    template <class Learner>
+    using Label = decltype(label_of(std::declval<const Learner&>(), 0));
+
+    template <class Learner>
+    void evaluate(ProgressiveMetrics& metrics, const Learner& learner, const Eigen::VectorXd& x, const int label) {
+      metrics.add(learner.compute_margin(x), label);
+    }
+
+    template <class Learner>
+    void evaluate(ProgressiveMetrics& metrics, const Learner& learner, const Eigen::VectorXd& x, const std::size_t label) {
+      metrics.add(learner.compute_scores(x), label);
+    }
+
+    // keeps the variadic constructor of a wrapper from taking over its copy constructor
+    template <class Self, typename... Args>
+    struct is_self : std::false_type { };
+
+    template <class Self, typename Arg>
+    struct is_self<Self, Arg> : std::is_same<typename std::decay<Arg>::type, Self> { };
+  };
+
+  // Single pass train / evaluate loop for any learner : each example is
+  // scored by the current model (progressive validation) and then learned.
+  template <class Learner>
+  class OnlineTrainer {
+  public :
+    using Label = detail::Label<Learner>;
+
+  private :
+    Learner _learner;
+    ProgressiveMetrics _metrics;
+
+  public :
+    template <typename... Args, typename = typename std::enable_if<!detail::is_self<OnlineTrainer, Args...>::value>::type>
+    explicit OnlineTrainer(Args&&... args)
+      : _learner(std::forward<Args>(args)...) { }
+
+    void learn(const Eigen::VectorXd& feature, const Label label) {
+      detail::evaluate(_metrics, _learner, feature, label);
+      _learner.update(feature, label);
+    }
+
+    // svmlight formatted stream, returns the number of examples learned
+    std::size_t train(std::istream& is, const std::size_t dim) {
+      std::size_t count = 0;
+      std::string line;
+      while (std::getline(is, line)) {
+        if (line.empty()) { continue; }
+        const auto data = utility::read_ones<Label>(line, dim);
+        learn(data.second, data.first);
+        ++count;
+      }
+      return count;
+    }
+
+    Learner& learner(void) { return _learner; }
+
+    const Learner& learner(void) const { return _learner; }
+
+    const ProgressiveMetrics& metrics(void) const { return _metrics; }
+  };
+
+};
+
+#endif //MOCHIMOCHI_TRAINER_ONLINE_TRAINER_HPP_
@@ -0,0 +1,128 @@
+#ifndef MOCHIMOCHI_TRAINER_PROGRESSIVE_METRICS_HPP_
+#define MOCHIMOCHI_TRAINER_PROGRESSIVE_METRICS_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace trainer {
+
+  // Approximate AUC over a stream : the margins are bucketed on a signed
+  // log scale, sign(m) * log(1 + |m|) in [-kRange, kRange], and the AUC is
+  // computed from the per-bucket counts of positive and negative examples
+  // (examples sharing a bucket count as ties).
+  class StreamingAUC {
+  public :
+    static constexpr std::size_t kBins = 4096;
+    static constexpr double kRange = 16.0;
+
+  private :
+    std::vector<std::uint64_t> _positives;
+    std::vector<std::uint64_t> _negatives;
+
+  public :
+    StreamingAUC() : _positives(kBins, 0), _negatives(kBins, 0) { }
+
+    void add(const double margin, const bool positive) {
+      const auto scaled = std::copysign(std::log1p(std::abs(margin)), margin);
+      const auto position = (std::min(std::max(scaled, -kRange), kRange) + kRange) / (2.0 * kRange);
+      const auto bin = std::min(static_cast<std::size_t>(position * kBins), kBins - 1);
+      ++(positive ? _positives : _negatives)[bin];
+    }
+
+    std::uint64_t count(void) const {
+      std::uint64_t total = 0;
+      for (std::size_t i = 0; i < kBins; ++i) { total += _positives[i] + _negatives[i]; }
+      return total;
+    }
+
+    double auc(void) const {
+      double below = 0.0;
+      double pairs = 0.0;
+      double positives = 0.0;
+      for (std::size_t i = 0; i < kBins; ++i) {
+        pairs += _positives[i] * (below + 0.5 * _negatives[i]);
+        below += _negatives[i];
+        positives += _positives[i];
+      }
+      return (positives == 0.0 || below == 0.0) ? 0.5 : pairs / (positives * below);
+    }
+  };
+
+  // Progressive validation : every example is evaluated by the model
+  // before it is used for the update.
+  class ProgressiveMetrics {
+  private :
+    std::uint64_t _examples;
+    std::uint64_t _correct;
+    double _hinge_loss;
+    double _log_loss;
+    StreamingAUC _auc;
+
+  public :
+    ProgressiveMetrics() : _examples(0), _correct(0), _hinge_loss(0.0), _log_loss(0.0) { }
+
+    // binary : margin of the example, label +1 / -1
+    void add(const double margin, const int label) {
+      const auto z = label * margin;
+      ++_examples;
+      if (((margin > 0.0) ? 1 : -1) == label) { ++_correct; }
+      _hinge_loss += std::max(0.0, 1.0 - z);
+      _log_loss += (z > 0.0) ? std::log1p(std::exp(-z)) : -z + std::log1p(std::exp(z));
+      _auc.add(margin, label > 0);
+    }
+
+    // multi-class : scores of every class, label 1 .. K
+    void add(const Eigen::VectorXd& scores, const std::size_t label) {
+      const auto correct = scores[label - 1];
+      auto rival = -std::numeric_limits<double>::infinity();
+      for (std::size_t k = 0; k < static_cast<std::size_t>(scores.size()); ++k) {
+        if (k != label - 1) { rival = std::max(rival, scores[k]); }
+      }
+      const auto top = std::max(correct, rival);
+      ++_examples;
+      if (correct > rival) { ++_correct; }
+      _hinge_loss += std::max(0.0, 1.0 - (correct - rival));
+      _log_loss += top + std::log((scores.array() - top).exp().sum()) - correct;
+    }
+
+    std::uint64_t examples(void) const { return _examples; }
+
+    double accuracy(void) const {
+      return _examples == 0 ? 0.0 : static_cast<double>(_correct) / _examples;
+    }
+
+    double hinge_loss(void) const {
+      return _examples == 0 ? 0.0 : _hinge_loss / _examples;
+    }
+
+    double log_loss(void) const {
+      return _examples == 0 ? 0.0 : _log_loss / _examples;
+    }
+
+    // binary learners only
+    bool has_auc(void) const {
+      return _auc.count() > 0;
+    }
+
+    double auc(void) const {
+      return _auc.auc();
+    }
+  };
+
+  inline std::ostream& operator<<(std::ostream& os, const ProgressiveMetrics& metrics) {
+    os << "examples=" << metrics.examples()
+       << " accuracy=" << metrics.accuracy()
+       << " hinge_loss=" << metrics.hinge_loss()
+       << " log_loss=" << metrics.log_loss();
+    if (metrics.has_auc()) { os << " auc=" << metrics.auc(); }
+    return os;
+  }
+
+};
+
+#endif //MOCHIMOCHI_TRAINER_PROGRESSIVE_METRICS_HPP_
@@ -0,0 +1,198 @@
+#ifndef MOCHIMOCHI_TRAINER_SWEEP_TRAINER_HPP_
+#define MOCHIMOCHI_TRAINER_SWEEP_TRAINER_HPP_
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../utility/load_svmlight_file.hpp"
+#include "./online_trainer.hpp"
+
+namespace trainer {
+
+  namespace detail {
+    using Example = std::pair<int, Eigen::VectorXd>;
+
+    class AnyTrainer {
+    public :
+      virtual ~AnyTrainer() { }
+      virtual void learn(const std::vector<Example>& batch) = 0;
+      virtual const ProgressiveMetrics& metrics(void) const = 0;
+    };
+
+    template <class Learner>
+    class SweepEntry : public AnyTrainer {
+    private :
+      OnlineTrainer<Learner> _trainer;
+
+    public :
+      template <typename... Args>
+      explicit SweepEntry(Args&&... args)
+        : _trainer(std::forward<Args>(args)...) { }
+
+      void learn(const std::vector<Example>& batch) override {
+        using Label = typename OnlineTrainer<Learner>::Label;
+        for (const auto& example : batch) {
+          _trainer.learn(example.second, static_cast<Label>(example.first));
+        }
+      }
+
+      const ProgressiveMetrics& metrics(void) const override {
+        return _trainer.metrics();
+      }
+
+      const Learner& learner(void) const {
+        return _trainer.learner();
+      }
+    };
+  };
+
+  // Trains many models (several hyper parameters and / or algorithms) on a
+  // single parse of the data. The examples are parsed in batches, then the
+  // threads (started once, the calling thread being one of them) take the
+  // models one by one from a shared counter and run the batch through them,
+  // so every model sees exactly the same stream as a standalone OnlineTrainer.
+  // All models must be binary, or all multi-class.
+  class SweepTrainer {
+  private :
+    const std::size_t kThreads;
+    const std::size_t kBatch;
+
+  private :
+    std::vector<std::string> _names;
+    std::vector<std::unique_ptr<detail::AnyTrainer>> _models;
+    const std::vector<detail::Example>* _batch;
+    std::atomic<std::size_t> _next;
+    std::uint64_t _epoch;
+    std::size_t _pending;
+    bool _stopping;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    std::vector<std::thread> _workers;
+
+  private :
+
+    // the models left in the current batch
+    void drain(void) {
+      for (auto i = _next.fetch_add(1); i < _models.size(); i = _next.fetch_add(1)) {
+        _models[i]->learn(*_batch);
+      }
+    }
+
+    void work(void) {
+      std::uint64_t seen = 0;
+      while (true) {
+        {
+          std::unique_lock<std::mutex> lock(_mutex);
+          _wake.wait(lock, [&]() { return _epoch != seen || _stopping; });
+          if (_stopping) { return; }
+          seen = _epoch;
+        }
+        drain();
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          if (--_pending != 0) { continue; }
+        }
+        _done.notify_one();
+      }
+    }
+
+  public :
+    explicit SweepTrainer(const std::size_t threads = std::max(1u, std::thread::hardware_concurrency()),
+                          const std::size_t batch = 1024)
+      : kThreads(threads),
+        kBatch(batch),
+        _batch(nullptr),
+        _next(0),
+        _epoch(0),
+        _pending(0),
+        _stopping(false) {
+      assert(threads > 0);
+      assert(batch > 0);
+      for (std::size_t t = 1; t < threads; ++t) {
+        _workers.emplace_back([this]() { work(); });
+      }
+    }
+
+    SweepTrainer(const SweepTrainer&) = delete;
+    SweepTrainer& operator=(const SweepTrainer&) = delete;
+
+    virtual ~SweepTrainer() {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+      }
+      _wake.notify_all();
+      for (auto& worker : _workers) { worker.join(); }
+    }
+
+    template <class Learner, typename... Args>
+    void add(const std::string& name, Args&&... args) {
+      _names.push_back(name);
+      _models.emplace_back(new detail::SweepEntry<Learner>(std::forward<Args>(args)...));
+    }
+
+    std::size_t train(std::istream& is, const std::size_t dim) {
+      std::size_t count = 0;
+      std::vector<detail::Example> batch;
+      batch.reserve(kBatch);
+      std::string line;
+      while (std::getline(is, line)) {
+        if (line.empty()) { continue; }
+        batch.push_back(utility::read_ones<int>(line, dim));
+        if (batch.size() == kBatch) {
+          learn(batch);
+          count += batch.size();
+          batch.clear();
+        }
+      }
+      learn(batch);
+      return count + batch.size();
+    }
+
+    void learn(const std::vector<detail::Example>& batch) {
+      if (batch.empty()) { return; }
+      if (_workers.empty() || _models.size() <= 1) {
+        for (auto& model : _models) { model->learn(batch); }
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _batch = &batch;
+        _next = 0;
+        _pending = _workers.size();
+        ++_epoch;
+      }
+      _wake.notify_all();
+
+      drain();
+      std::unique_lock<std::mutex> lock(_mutex);
+      _done.wait(lock, [&]() { return _pending == 0; });
+    }
+
+    std::size_t size(void) const { return _models.size(); }
+
+    const std::string& name(const std::size_t i) const { return _names.at(i); }
+
+    const ProgressiveMetrics& metrics(const std::size_t i) const { return _models.at(i)->metrics(); }
+
+    template <class Learner>
+    const Learner& learner(const std::size_t i) const {
+      return dynamic_cast<const detail::SweepEntry<Learner>&>(*_models.at(i)).learner();
+    }
+  };
+
+};
+
+#endif //MOCHIMOCHI_TRAINER_SWEEP_TRAINER_HPP_
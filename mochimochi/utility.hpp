@@ -2,5 +2,6 @@
 #define MOCHIMOCHI_UTILITY_HPP_
 
 #include "./utility/load_svmlight_file.hpp"
+#include "./utility/duplicate_compactor.hpp"
 
 #endif //MOCHIMOCHI_UTILITY_HPP_
@@ -0,0 +1,122 @@
+#ifndef MOCHIMOCHI_UTILITY_DUPLICATE_COMPACTOR_HPP_
+#define MOCHIMOCHI_UTILITY_DUPLICATE_COMPACTOR_HPP_
+
+#include <Eigen/Dense>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace utility {
+
+  // Collapses the exact duplicates (same label and feature vector) of a stream into
+  // single examples weighted by their count, for the learners' update(feature, label, weight).
+  // Up to `capacity` distinct examples are held; they are handed to the sink
+  // (sink(feature, label, weight)) in the order of their first occurrence when
+  // the window is full and on flush. A larger window finds more duplicates but
+  // delays more examples, which matters for online learning.
+  template <typename Label>
+  class DuplicateCompactor {
+  private :
+    const std::size_t kDim;
+    const std::size_t kCapacity;
+
+  private :
+    std::vector<Eigen::VectorXd> _features;
+    std::vector<Label> _labels;
+    std::vector<double> _weights;
+    std::vector<long> _next;
+    std::unordered_map<std::uint64_t, long> _first;
+    std::size_t _size;
+    std::uint64_t _seen;
+    std::uint64_t _emitted;
+
+  private :
+    static std::uint64_t mix(std::uint64_t h) {
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdULL;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ULL;
+      return h ^ (h >> 33);
+    }
+
+    static std::uint64_t hash(const Eigen::VectorXd& feature, const Label label) {
+      auto h = mix(static_cast<std::uint64_t>(label));
+      for (std::size_t i = 0; i < static_cast<std::size_t>(feature.size()); ++i) {
+        if (feature[i] == 0.0) { continue; }
+        std::uint64_t bits;
+        std::memcpy(&bits, &feature[i], sizeof(bits));
+        h += (bits ^ (0x9e3779b97f4a7c15ULL * (i + 1))) * 0xbf58476d1ce4e5b9ULL;
+      }
+      return mix(h);
+    }
+
+  public :
+    DuplicateCompactor(const std::size_t dim, const std::size_t capacity)
+      : kDim(dim),
+        kCapacity(capacity),
+        _features(capacity, Eigen::VectorXd::Zero(dim)),
+        _labels(capacity),
+        _weights(capacity, 0.0),
+        _next(capacity, -1),
+        _size(0),
+        _seen(0),
+        _emitted(0) {
+      assert(capacity > 0);
+      _first.reserve(2 * capacity);
+    }
+
+    virtual ~DuplicateCompactor() { }
+
+  public :
+
+    template <class Sink>
+    void add(const Eigen::VectorXd& feature, const Label label, const double weight, Sink&& sink) {
+      assert(static_cast<std::size_t>(feature.size()) == kDim);
+      ++_seen;
+      const auto h = hash(feature, label);
+      const auto found = _first.find(h);
+      if (found != _first.end()) {
+        for (auto slot = found->second; slot >= 0; slot = _next[slot]) {
+          if (_labels[slot] == label && _features[slot] == feature) {
+            _weights[slot] += weight;
+            return;
+          }
+        }
+      }
+
+      if (_size == kCapacity) { flush(sink); }
+      const auto slot = static_cast<long>(_size++);
+      _features[slot] = feature;
+      _labels[slot] = label;
+      _weights[slot] = weight;
+      auto& head = _first.emplace(h, -1).first->second;
+      _next[slot] = head;
+      head = slot;
+    }
+
+    template <class Sink>
+    void add(const Eigen::VectorXd& feature, const Label label, Sink&& sink) {
+      add(feature, label, 1.0, sink);
+    }
+
+    template <class Sink>
+    void flush(Sink&& sink) {
+      for (std::size_t slot = 0; slot < _size; ++slot) {
+        sink(_features[slot], _labels[slot], _weights[slot]);
+      }
+      _emitted += _size;
+      _size = 0;
+      _first.clear();
+    }
+
+    // examples added and distinct examples handed to the sink so far
+    std::uint64_t seen(void) const { return _seen; }
+
+    std::uint64_t emitted(void) const { return _emitted; }
+  };
+
+};
+
+#endif //MOCHIMOCHI_UTILITY_DUPLICATE_COMPACTOR_HPP_
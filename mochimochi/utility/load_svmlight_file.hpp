@@ -2,6 +2,7 @@
 #define MOCHIMOCHI_LOAD_SVMLIGHT_FILE_HPP_
 
 #include <Eigen/Dense>
+#include <cstdlib>
 #include <fstream>
 #include <sstream>
 #include <map>
@@ -26,6 +27,23 @@ namespace utility {
     }
     return std::make_pair(label, values);
   }
+
+  // Parses into `values` (already sized to the dimension) and returns the label.
+  // Nothing is allocated, so a loop reusing the line and the vector runs allocation free.
+  template<typename T>
+  inline T read_ones(const std::string& line, Eigen::VectorXd& values) {
+    values.setZero();
+    const char* p = line.c_str();
+    char* end;
+    const auto label = static_cast<T>(std::strtol(p, &end, 10));
+    for (p = end; ; ) {
+      const auto number = std::strtol(p, &end, 10);
+      if (end == p || *end != ':') { break; }
+      values(number - 1) = std::strtod(end + 1, &end);
+      p = end;
+    }
+    return label;
+  }
 }
 
 #endif //MOCHIMOCHI_LOAD_SVMLIGHT_FILE_HPP_